@@ -17,7 +17,12 @@ namespace parasols
         RepairSelected,
         RepairSelectedDefer1,
         RepairSelectedFast,
-        RepairAllFast
+        RepairAllFast,
+        RepairAllBitSet,
+        RepairAllDefer1BitSet,
+        RepairSelectedBitSet,
+        RepairSelectedDefer1BitSet,
+        Inherit
     };
 }
 
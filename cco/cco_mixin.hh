@@ -24,14 +24,15 @@ namespace parasols
     template <unsigned size_, typename VertexType_, typename ActualType_, bool inverse_>
     struct CCOMixin
     {
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::None> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int = 0) -> void
         {
-            FixedBitSet<size_> p_left = p; // not coloured yet
+            BitSet_ p_left = p; // not coloured yet
             VertexType_ colour = 0;        // current colour
             VertexType_ i = 0;             // position in p_bounds
 
@@ -40,12 +41,11 @@ namespace parasols
                 // next colour
                 ++colour;
                 // things that can still be given this colour
-                FixedBitSet<size_> q = p_left;
+                BitSet_ q = p_left;
 
-                // while we can still give something this colour
-                while (! q.empty()) {
-                    // first thing we can colour
-                    int v = q.first_set_bit();
+                // while we can still give something this colour, give it to the
+                // first thing we can colour
+                for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
                     p_left.unset(v);
                     q.unset(v);
 
@@ -63,32 +63,33 @@ namespace parasols
             }
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::Defer1> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int = 0) -> void
         {
-            FixedBitSet<size_> p_left = p; // not coloured yet
+            BitSet_ p_left = p; // not coloured yet
             VertexType_ colour = 0;        // current colour
             VertexType_ i = 0;             // position in p_bounds
 
             VertexType_ d = 0;             // number deferred
-            std::array<VertexType_, size_ * bits_per_word> defer;
+            VertexArray<size_, VertexType_> defer;
+            resize_vertex_array(defer, static_cast<ActualType_ *>(this)->graph.size());
 
             // while we've things left to colour
             while (! p_left.empty()) {
                 // next colour
                 ++colour;
                 // things that can still be given this colour
-                FixedBitSet<size_> q = p_left;
+                BitSet_ q = p_left;
 
-                // while we can still give something this colour
+                // while we can still give something this colour, give it to the
+                // first thing we can colour
                 unsigned number_with_this_colour = 0;
-                while (! q.empty()) {
-                    // first thing we can colour
-                    int v = q.first_set_bit();
+                for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
                     p_left.unset(v);
                     q.unset(v);
 
@@ -120,10 +121,134 @@ namespace parasols
             }
         }
 
+        /**
+         * Colour p, which is a subset of the first parent_n vertices of a
+         * parent whose colouring we already have. Restricting the parent's
+         * colour classes to p gives a colouring of p for next to nothing,
+         * and we then try to empty out any singleton classes by moving their
+         * vertex into an earlier class. If that's enough to show p can't
+         * have more than delta vertices in a clique, it's all we need.
+         * Otherwise we colour p from scratch, as for Defer1, to get the
+         * tightest bound we can.
+         */
+        template <typename BitSet_>
+        auto colour_class_order_from_parent(
+                const BitSet_ & p,
+                const VertexArray<size_, VertexType_> & parent_p_order,
+                const VertexArray<size_, VertexType_> & parent_p_bounds,
+                int parent_n,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta
+                ) -> void
+        {
+            static_assert(! inverse_, "inverse_ not implemented here");
+
+            // how many of the parent's colour classes survive? Moving
+            // singletons can't get rid of anything bigger, so give up as soon
+            // as there are too many of those.
+            int number_of_colours = 0, number_of_singletons = 0;
+            for (int x = 0 ; x < parent_n ; ) {
+                int members = 0;
+                for (auto colour = parent_p_bounds[x] ; x < parent_n && parent_p_bounds[x] == colour ; ++x)
+                    if (p.test(parent_p_order[x]))
+                        ++members;
+
+                if (0 != members)
+                    ++number_of_colours;
+                if (1 == members)
+                    ++number_of_singletons;
+
+                if (number_of_colours - number_of_singletons > delta) {
+                    colour_class_order(SelectColourClassOrderOverload<CCOPermutations::Defer1>(), p, p_order, p_bounds);
+                    return;
+                }
+            }
+
+            // the parent's colour classes, restricted to p
+            static thread_local std::vector<std::vector<VertexType_> > colour_classes;
+            int colour_classes_end = number_of_colours;
+            if (colour_classes.size() < unsigned(colour_classes_end + 1))
+                colour_classes.resize(colour_classes_end + 1);
+
+            for (int x = 0, colour_class = 0 ; x < parent_n ; ) {
+                colour_classes[colour_class].clear();
+                for (auto colour = parent_p_bounds[x] ; x < parent_n && parent_p_bounds[x] == colour ; ++x)
+                    if (p.test(parent_p_order[x]))
+                        colour_classes[colour_class].push_back(parent_p_order[x]);
+
+                if (! colour_classes[colour_class].empty())
+                    ++colour_class;
+            }
+
+            // try to get rid of singleton classes
+            for (int colour_class = colour_classes_end - 1 ; colour_class > 0 && number_of_colours > delta ; --colour_class) {
+                if (1 != colour_classes[colour_class].size())
+                    continue;
+
+                // not enough singletons left to get us there?
+                if (number_of_colours - number_of_singletons-- > delta)
+                    break;
+
+                auto v = colour_classes[colour_class][0];
+                for (int new_colour_class = 0 ; new_colour_class < colour_class ; ++new_colour_class) {
+                    auto & members = colour_classes[new_colour_class];
+                    if (members.empty())
+                        continue;
+
+                    bool conflict = false;
+                    for (auto & w : members)
+                        if (static_cast<ActualType_ *>(this)->graph.adjacent(v, w)) {
+                            conflict = true;
+                            break;
+                        }
+
+                    if (! conflict) {
+                        members.push_back(v);
+                        colour_classes[colour_class].clear();
+                        --number_of_colours;
+                        break;
+                    }
+                }
+            }
+
+            if (number_of_colours > delta) {
+                colour_class_order(SelectColourClassOrderOverload<CCOPermutations::Defer1>(), p, p_order, p_bounds);
+                return;
+            }
+
+            VertexType_ colour = 0;        // current colour
+            VertexType_ i = 0;             // position in p_bounds
+            for (int colour_class = 0 ; colour_class != colour_classes_end ; ++colour_class) {
+                if (colour_classes[colour_class].empty())
+                    continue;
+
+                ++colour;
+                for (auto & v : colour_classes[colour_class]) {
+                    p_bounds[i] = colour;
+                    p_order[i] = v;
+                    ++i;
+                }
+            }
+        }
+
+        template <typename BitSet_>
+        auto colour_class_order(
+                const SelectColourClassOrderOverload<CCOPermutations::Inherit> &,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int = 0) -> void
+        {
+            // nothing to inherit from
+            colour_class_order(SelectColourClassOrderOverload<CCOPermutations::Defer1>(), p, p_order, p_bounds);
+        }
+
+        template <typename BitSet_>
         auto colour_class_order_with_repair(
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta,
                 bool selective,
                 bool do_defer
@@ -131,13 +256,12 @@ namespace parasols
         {
             static_assert(! inverse_, "inverse_ not implemented here");
 
-            static thread_local std::vector<std::pair<int, std::array<VertexType_, size_ * bits_per_word> > > colour_classes;
+            static thread_local std::vector<std::pair<int, VertexArray<size_, VertexType_> > > colour_classes;
 
-            FixedBitSet<size_> p_left = p; // not coloured yet
+            BitSet_ p_left = p; // not coloured yet
             int colour_classes_end = 0;
 
-            while (! p_left.empty()) {
-                int v = p_left.first_set_bit();
+            for (int v = p_left.first_set_bit() ; v != -1 ; v = p_left.first_set_bit()) {
                 p_left.unset(v);
 
                 bool coloured = false;
@@ -200,6 +324,7 @@ namespace parasols
                     if (! repaired) {
                         if (colour_classes.size() < unsigned(colour_classes_end + 1))
                             colour_classes.resize(colour_classes_end + 1);
+                        resize_vertex_array(colour_classes[colour_classes_end].second, static_cast<ActualType_ *>(this)->graph.size());
 
                         colour_classes[colour_classes_end].first = 1;
                         colour_classes[colour_classes_end].second[0] = v;
@@ -211,7 +336,8 @@ namespace parasols
             VertexType_ colour = 0;        // current colour
             VertexType_ i = 0;             // position in p_bounds
             VertexType_ d = 0;             // number deferred
-            std::array<VertexType_, size_ * bits_per_word> defer;
+            VertexArray<size_, VertexType_> defer;
+            resize_vertex_array(defer, static_cast<ActualType_ *>(this)->graph.size());
             for (int colour_class = 0 ; colour_class != colour_classes_end ; ++colour_class) {
                 if (do_defer && 1 == colour_classes[colour_class].first)
                     defer[d++] = colour_classes[colour_class].second[0];
@@ -234,52 +360,215 @@ namespace parasols
                 }
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairAll> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta = 0) -> void
         {
             colour_class_order_with_repair(p, p_order, p_bounds, delta, false, false);
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairAllDefer1> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta = 0) -> void
         {
             colour_class_order_with_repair(p, p_order, p_bounds, delta, false, true);
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairSelected> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta
                 ) -> void
         {
             colour_class_order_with_repair(p, p_order, p_bounds, delta, true, false);
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairSelectedDefer1> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta
                 ) -> void
         {
             colour_class_order_with_repair(p, p_order, p_bounds, delta, true, true);
         }
 
+        /**
+         * As colour_class_order_with_repair, but with each colour class kept
+         * as a bitset. Checking v against a colour class is then a single
+         * intersection with v's row, rather than an adjacency test for every
+         * member, and a repair just moves a bit from one class to another.
+         *
+         * Each colour class comes out in vertex order, so a repaired class
+         * can be ordered differently to colour_class_order_with_repair, but
+         * the classes themselves are the same.
+         */
+        template <typename BitSet_>
+        auto colour_class_order_with_bitset_repair(
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta,
+                bool selective,
+                bool do_defer
+                ) -> void
+        {
+            static_assert(! inverse_, "inverse_ not implemented here");
+
+            const auto & graph = static_cast<ActualType_ *>(this)->graph;
+
+            // these are always left empty, so they can be reused
+            static thread_local std::vector<std::pair<int, BitSet<size_> > > colour_classes;
+
+            BitSet_ p_left = p; // not coloured yet
+            int colour_classes_end = 0;
+
+            for (int v = p_left.first_set_bit() ; v != -1 ; v = p_left.first_set_bit()) {
+                p_left.unset(v);
+
+                bool coloured = false;
+                for (int colour_class = 0 ; colour_class != colour_classes_end ; ++colour_class)
+                    if (-1 == graph.first_common_bit_with_row(v, colour_classes[colour_class].second)) {
+                        coloured = true;
+                        colour_classes[colour_class].second.set(v);
+                        ++colour_classes[colour_class].first;
+                        break;
+                    }
+
+                if (! coloured) {
+                    bool repaired = false;
+
+                    if ((! selective) || (colour_classes_end >= delta)) {
+                        for (int colour_class = 0 ; colour_class < colour_classes_end - 1 && ! repaired ; ++colour_class) {
+                            // v conflicts with every class, so this finds something
+                            auto & from = colour_classes[colour_class].second;
+                            int vertex_to_move = graph.first_common_bit_with_row(v, from);
+                            if (-1 != graph.first_common_bit_with_row(v, from, vertex_to_move + 1))
+                                continue;
+
+                            for (int new_colour_class = colour_class + 1 ; new_colour_class < colour_classes_end ; ++new_colour_class) {
+                                auto & to = colour_classes[new_colour_class].second;
+                                if (-1 == graph.first_common_bit_with_row(vertex_to_move, to)) {
+                                    repaired = true;
+                                    from.unset(vertex_to_move);
+                                    from.set(v);
+                                    to.set(vertex_to_move);
+                                    ++colour_classes[new_colour_class].first;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    if (! repaired) {
+                        if (colour_classes.size() < unsigned(colour_classes_end + 1)) {
+                            colour_classes.resize(colour_classes_end + 1);
+                            colour_classes[colour_classes_end].second.resize(graph.size());
+                        }
+
+                        colour_classes[colour_classes_end].first = 1;
+                        colour_classes[colour_classes_end].second.set(v);
+                        ++colour_classes_end;
+                    }
+                }
+            }
+
+            VertexType_ colour = 0;        // current colour
+            VertexType_ i = 0;             // position in p_bounds
+            VertexType_ d = 0;             // number deferred
+            VertexArray<size_, VertexType_> defer;
+            resize_vertex_array(defer, graph.size());
+            for (int colour_class = 0 ; colour_class != colour_classes_end ; ++colour_class) {
+                auto & members = colour_classes[colour_class].second;
+                if (do_defer && 1 == colour_classes[colour_class].first) {
+                    int v = members.first_set_bit();
+                    members.unset(v);
+                    defer[d++] = v;
+                }
+                else {
+                    ++colour;
+                    for (int v = members.first_set_bit() ; v != -1 ; v = members.first_set_bit()) {
+                        members.unset(v);
+                        p_bounds[i] = colour;
+                        p_order[i] = v;
+                        ++i;
+                    }
+                }
+            }
+
+            if (do_defer)
+                for (VertexType_ n = 0 ; n < d ; ++n) {
+                    ++colour;
+                    p_order[i] = defer[n];
+                    p_bounds[i] = colour;
+                    i++;
+                }
+        }
+
+        template <typename BitSet_>
+        auto colour_class_order(
+                const SelectColourClassOrderOverload<CCOPermutations::RepairAllBitSet> &,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta = 0) -> void
+        {
+            colour_class_order_with_bitset_repair(p, p_order, p_bounds, delta, false, false);
+        }
+
+        template <typename BitSet_>
+        auto colour_class_order(
+                const SelectColourClassOrderOverload<CCOPermutations::RepairAllDefer1BitSet> &,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta = 0) -> void
+        {
+            colour_class_order_with_bitset_repair(p, p_order, p_bounds, delta, false, true);
+        }
+
+        template <typename BitSet_>
+        auto colour_class_order(
+                const SelectColourClassOrderOverload<CCOPermutations::RepairSelectedBitSet> &,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta
+                ) -> void
+        {
+            colour_class_order_with_bitset_repair(p, p_order, p_bounds, delta, true, false);
+        }
+
+        template <typename BitSet_>
+        auto colour_class_order(
+                const SelectColourClassOrderOverload<CCOPermutations::RepairSelectedDefer1BitSet> &,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
+                int delta
+                ) -> void
+        {
+            colour_class_order_with_bitset_repair(p, p_order, p_bounds, delta, true, true);
+        }
+
+        template <typename BitSet_>
         auto colour_class_order_with_repair_fast(
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta,
                 bool selective) -> void
         {
@@ -288,7 +577,7 @@ namespace parasols
             static unsigned call_number = 0;
             ++call_number;
 
-            FixedBitSet<size_> p_left = p; // not coloured yet
+            BitSet_ p_left = p; // not coloured yet
             VertexType_ colour = 0;        // current colour
             VertexType_ i = 0;             // position in p_bounds
 
@@ -384,12 +673,11 @@ namespace parasols
                 ++colour;
 
                 // things that can still be given this colour
-                FixedBitSet<size_> q = p_left;
+                BitSet_ q = p_left;
 
-                // while we can still give something this colour
-                while (! q.empty()) {
-                    // first thing we can colour
-                    int v = q.first_set_bit();
+                // while we can still give something this colour, give it to the
+                // first thing we can colour
+                for (int v = q.first_set_bit() ; v != -1 ; v = q.first_set_bit()) {
                     p_left.unset(v);
                     q.unset(v);
 
@@ -404,21 +692,23 @@ namespace parasols
             }
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairSelectedFast> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta = 0) -> void
         {
             colour_class_order_with_repair_fast(p, p_order, p_bounds, delta, true);
         }
 
+        template <typename BitSet_>
         auto colour_class_order(
                 const SelectColourClassOrderOverload<CCOPermutations::RepairAllFast> &,
-                const FixedBitSet<size_> & p,
-                std::array<VertexType_, size_ * bits_per_word> & p_order,
-                std::array<VertexType_, size_ * bits_per_word> & p_bounds,
+                const BitSet_ & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & p_bounds,
                 int delta = 0) -> void
         {
             colour_class_order_with_repair_fast(p, p_order, p_bounds, delta, false);
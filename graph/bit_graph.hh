@@ -3,20 +3,20 @@
 #ifndef PARASOLS_GUARD_GRAPH_BIT_GRAPH_HH
 #define PARASOLS_GUARD_GRAPH_BIT_GRAPH_HH 1
 
+#include <graph/bit_kernels.hh>
+
 #include <array>
 #include <vector>
 #include <tuple>
 #include <utility>
 #include <algorithm>
+#include <type_traits>
+#include <new>
+#include <cstdlib>
+#include <memory>
 
 namespace parasols
 {
-    /// We'll use an array of unsigned long longs to represent our bits.
-    using BitWord = unsigned long long;
-
-    /// Number of bits per word.
-    static const constexpr int bits_per_word = sizeof(BitWord) * 8;
-
     /**
      * A bitset with a fixed maximum size. This only provides the operations
      * we actually use in the bitset algorithms: it's more readable this way
@@ -33,6 +33,28 @@ namespace parasols
             Bits _bits = {{ }};
 
         public:
+            /**
+             * Make sure we can hold size bits. We're fixed size, so this does
+             * nothing, but it lets code be written to work with both us and
+             * DynamicBitSet.
+             */
+            auto resize(int) -> void
+            {
+            }
+
+            /**
+             * Our words, for things that work on them directly.
+             */
+            auto data() -> BitWord *
+            {
+                return _bits.data();
+            }
+
+            auto data() const -> const BitWord *
+            {
+                return _bits.data();
+            }
+
             /**
              * Set a given bit 'on'.
              */
@@ -104,10 +126,7 @@ namespace parasols
              */
             auto popcount() const -> unsigned
             {
-                unsigned result = 0;
-                for (auto & p : _bits)
-                    result += __builtin_popcountll(p);
-                return result;
+                return bit_kernels::popcount(_bits.data(), words_);
             }
 
             /**
@@ -115,10 +134,7 @@ namespace parasols
              */
             auto empty() const -> bool
             {
-                for (auto & p : _bits)
-                    if (0 != p)
-                        return false;
-                return true;
+                return bit_kernels::empty(_bits.data(), words_);
             }
 
             /**
@@ -126,8 +142,44 @@ namespace parasols
              */
             auto intersect_with(const FixedBitSet<words_> & other) -> void
             {
-                for (typename Bits::size_type i = 0 ; i < words_ ; ++i)
-                    _bits[i] = _bits[i] & other._bits[i];
+                bit_kernels::intersect(_bits.data(), other._bits.data(), words_);
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return how many
+             * bits are on afterwards.
+             */
+            auto intersect_with_and_popcount(const FixedBitSet<words_> & other) -> unsigned
+            {
+                return bit_kernels::intersect_and_popcount(_bits.data(), other._bits.data(), words_);
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return whether we
+             * are now empty.
+             */
+            auto intersect_with_and_test_empty(const FixedBitSet<words_> & other) -> bool
+            {
+                return bit_kernels::intersect_and_test_empty(_bits.data(), other._bits.data(), words_);
+            }
+
+            /**
+             * Return the index of the first bit at or after from which is on
+             * in both us and another set, or -1 if there isn't one. Neither
+             * set is changed.
+             */
+            auto first_common_bit(const FixedBitSet<words_> & other, int from = 0) const -> int
+            {
+                unsigned w = from / bits_per_word;
+                if (w >= words_)
+                    return -1;
+
+                BitWord common = _bits[w] & other._bits[w] & (~BitWord(0) << (from % bits_per_word));
+                if (0 != common)
+                    return w * bits_per_word + __builtin_ctzll(common);
+
+                int b = bit_kernels::first_common_bit(_bits.data() + w + 1, other._bits.data() + w + 1, words_ - w - 1);
+                return -1 == b ? -1 : (w + 1) * bits_per_word + b;
             }
 
             /**
@@ -144,8 +196,7 @@ namespace parasols
              */
             auto intersect_with_complement(const FixedBitSet<words_> & other) -> void
             {
-                for (typename Bits::size_type i = 0 ; i < words_ ; ++i)
-                    _bits[i] = _bits[i] & ~other._bits[i];
+                bit_kernels::intersect_complement(_bits.data(), other._bits.data(), words_);
             }
 
             /**
@@ -154,12 +205,7 @@ namespace parasols
              */
             auto first_set_bit() const -> int
             {
-                for (typename Bits::size_type i = 0 ; i < _bits.size() ; ++i) {
-                    int b = __builtin_ffsll(_bits[i]);
-                    if (0 != b)
-                        return i * bits_per_word + b - 1;
-                }
-                return -1;
+                return bit_kernels::first_set_bit(_bits.data(), words_);
             }
 
             /**
@@ -196,6 +242,9 @@ namespace parasols
      * matrix representation. This only provides the operations we actually use
      * in the bitset algorithms.
      *
+     * The intersect_with_row family will take either a FixedBitSet<size_> or
+     * a WordRangeBitSet<size_>.
+     *
      * Indices start at 0.
      */
     template <unsigned size_>
@@ -243,6 +292,29 @@ namespace parasols
                 _adjacency[b].set_atomic(a);
             }
 
+            /**
+             * Add an edge from a to b, but not from b to a. For building a
+             * row at a time, see encode_bit_graph(); the caller is
+             * responsible for keeping things symmetric.
+             */
+            auto add_arc(int a, int b) -> void
+            {
+                _adjacency[a].set(b);
+            }
+
+            /**
+             * Become the subgraph of g induced by p, which has the given
+             * vertices on, with vertices renumbered by where they come in p.
+             */
+            template <typename Graph_, typename BitSet_, typename Vertices_>
+            auto induce(const Graph_ & g, const BitSet_ & p, const Vertices_ & vertices) -> void
+            {
+                _size = vertices.size();
+                _adjacency.assign(_size, FixedBitSet<size_>{ });
+                for (int i = 0 ; i < _size ; ++i)
+                    g.pack_row(vertices[i], p, _adjacency[i]);
+            }
+
             /**
              * Are vertices a and b adjacent?
              */
@@ -262,18 +334,71 @@ namespace parasols
             /**
              * Intersect the supplied bitset with a particular row.
              */
-            auto intersect_with_row(int row, FixedBitSet<size_> & p) const -> void
+            template <typename BitSet_>
+            auto intersect_with_row(int row, BitSet_ & p) const -> void
             {
                 p.intersect_with(_adjacency[row]);
             }
 
+            /**
+             * Intersect the supplied bitset with a particular row, and return
+             * how many bits it has left.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_and_popcount(int row, BitSet_ & p) const -> unsigned
+            {
+                return p.intersect_with_and_popcount(_adjacency[row]);
+            }
+
+            /**
+             * Intersect the supplied bitset with a particular row, and return
+             * whether it is now empty.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_and_test_empty(int row, BitSet_ & p) const -> bool
+            {
+                return p.intersect_with_and_test_empty(_adjacency[row]);
+            }
+
+            /**
+             * Return the first vertex at or after from which is in p and
+             * adjacent to a particular vertex, or -1. p is not changed.
+             */
+            auto first_common_bit_with_row(int row, const FixedBitSet<size_> & p, int from = 0) const -> int
+            {
+                return _adjacency[row].first_common_bit(p, from);
+            }
+
             /**
              * Intersect the supplied bitset with the complement of a
              * particular row.
              */
-            auto intersect_with_row_complement(int row, FixedBitSet<size_> & p) const -> void
+            template <typename BitSet_>
+            auto intersect_with_row_complement(int row, BitSet_ & p) const -> void
+            {
+                p.intersect_with_complement(_adjacency[row]);
+            }
+
+            /**
+             * Intersect the supplied bitset with the complement of a
+             * particular row, and return whether it is now empty.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_complement_and_test_empty(int row, BitSet_ & p) const -> bool
             {
                 p.intersect_with_complement(_adjacency[row]);
+                return p.empty();
+            }
+
+            /**
+             * Pack the neighbours of a particular vertex which are in p
+             * into result, numbering them by where they come in p (see
+             * WordRangeBitSet::pack).
+             */
+            template <typename BitSet_, typename Result_>
+            auto pack_row(int row, const BitSet_ & p, Result_ & result) const -> void
+            {
+                p.pack(_adjacency[row], result);
             }
 
             /**
@@ -294,6 +419,809 @@ namespace parasols
             }
     };
 
+    /// Size of a cache line, for alignment purposes.
+    static const constexpr int cache_line_size = 64;
+
+    /**
+     * An allocator that hands out cache line aligned storage, for
+     * DynamicBitSet.
+     */
+    template <typename T_>
+    struct CacheLineAlignedAllocator
+    {
+        using value_type = T_;
+
+        CacheLineAlignedAllocator() = default;
+
+        template <typename U_>
+        CacheLineAlignedAllocator(const CacheLineAlignedAllocator<U_> &)
+        {
+        }
+
+        auto allocate(std::size_t n) -> T_ *
+        {
+            void * result = nullptr;
+            if (0 != posix_memalign(&result, cache_line_size, n * sizeof(T_)))
+                throw std::bad_alloc();
+            return static_cast<T_ *>(result);
+        }
+
+        auto deallocate(T_ * p, std::size_t) -> void
+        {
+            std::free(p);
+        }
+
+        template <typename U_>
+        auto operator== (const CacheLineAlignedAllocator<U_> &) const -> bool
+        {
+            return true;
+        }
+
+        template <typename U_>
+        auto operator!= (const CacheLineAlignedAllocator<U_> &) const -> bool
+        {
+            return false;
+        }
+    };
+
+    /**
+     * A bitset whose size is decided at runtime, rather than being rounded up
+     * to one of the sizes we instantiate FixedBitSet with. Provides the same
+     * operations as FixedBitSet. Must be resize()d before use, and all sets
+     * used together must have the same size.
+     *
+     * Indices start at 0.
+     */
+    class DynamicBitSet
+    {
+        private:
+            using Bits = std::vector<BitWord, CacheLineAlignedAllocator<BitWord> >;
+
+            Bits _bits;
+
+        public:
+            /**
+             * Make sure we can hold size bits. Any new bits are off.
+             */
+            auto resize(int size) -> void
+            {
+                _bits.resize((size + bits_per_word - 1) / bits_per_word);
+            }
+
+            /**
+             * Our words, for things that work on them directly.
+             */
+            auto data() const -> const BitWord *
+            {
+                return _bits.data();
+            }
+
+            /**
+             * Set a given bit 'on'.
+             */
+            auto set(int a) -> void
+            {
+                _bits[a / bits_per_word] |= (BitWord{ 1 } << (a % bits_per_word));
+            }
+
+            /**
+             * Set a given bit 'on'.
+             */
+            auto set_atomic(int a) -> void
+            {
+                __sync_or_and_fetch(&_bits[a / bits_per_word], (BitWord{ 1 } << (a % bits_per_word)));
+            }
+
+            /**
+             * Set a given bit 'off'.
+             */
+            auto unset(int a) -> void
+            {
+                _bits[a / bits_per_word] &= ~(BitWord{ 1 } << (a % bits_per_word));
+            }
+
+            /**
+             * Set all bits on.
+             */
+            auto set_up_to(int size) -> void
+            {
+                unset_all();
+                for (int i = 0 ; i < size ; ++i)
+                    set(i);
+            }
+
+            /**
+             * Set all bits off.
+             */
+            auto unset_all() -> void
+            {
+                std::fill(_bits.begin(), _bits.end(), 0);
+            }
+
+            /**
+             * Complement.
+             */
+            auto complement_up_to(int size) -> void
+            {
+                for (auto & p : _bits)
+                    p = ~p;
+                for (unsigned i = size ; i < _bits.size() * bits_per_word ; ++i)
+                    unset(i);
+            }
+
+            /**
+             * Is a given bit on?
+             */
+            auto test(int a) const -> bool
+            {
+                return _bits[a / bits_per_word] & (BitWord{ 1 } << (a % bits_per_word));
+            }
+
+            /**
+             * How many bits are on?
+             */
+            auto popcount() const -> unsigned
+            {
+                return bit_kernels::popcount(_bits.data(), _bits.size());
+            }
+
+            /**
+             * Are any bits on?
+             */
+            auto empty() const -> bool
+            {
+                return bit_kernels::empty(_bits.data(), _bits.size());
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set.
+             */
+            auto intersect_with(const DynamicBitSet & other) -> void
+            {
+                bit_kernels::intersect(_bits.data(), other._bits.data(), _bits.size());
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return how many
+             * bits are on afterwards.
+             */
+            auto intersect_with_and_popcount(const DynamicBitSet & other) -> unsigned
+            {
+                return bit_kernels::intersect_and_popcount(_bits.data(), other._bits.data(), _bits.size());
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return whether we
+             * are now empty.
+             */
+            auto intersect_with_and_test_empty(const DynamicBitSet & other) -> bool
+            {
+                return bit_kernels::intersect_and_test_empty(_bits.data(), other._bits.data(), _bits.size());
+            }
+
+            /**
+             * Return the index of the first bit at or after from which is on
+             * in both us and another set, or -1 if there isn't one. Neither
+             * set is changed.
+             */
+            auto first_common_bit(const DynamicBitSet & other, int from = 0) const -> int
+            {
+                Bits::size_type w = from / bits_per_word;
+                if (w >= _bits.size())
+                    return -1;
+
+                BitWord common = _bits[w] & other._bits[w] & (~BitWord(0) << (from % bits_per_word));
+                if (0 != common)
+                    return w * bits_per_word + __builtin_ctzll(common);
+
+                int b = bit_kernels::first_common_bit(_bits.data() + w + 1, other._bits.data() + w + 1, _bits.size() - w - 1);
+                return -1 == b ? -1 : (w + 1) * bits_per_word + b;
+            }
+
+            /**
+             * Union (bitwise-or) with another set.
+             */
+            auto union_with(const DynamicBitSet & other) -> void
+            {
+                for (Bits::size_type i = 0, i_end = _bits.size() ; i < i_end ; ++i)
+                    _bits[i] = _bits[i] | other._bits[i];
+            }
+
+            /**
+             * Intersect with the complement of another set.
+             */
+            auto intersect_with_complement(const DynamicBitSet & other) -> void
+            {
+                bit_kernels::intersect_complement(_bits.data(), other._bits.data(), _bits.size());
+            }
+
+            /**
+             * Return the index of the first set ('on') bit, or -1 if we are
+             * empty.
+             */
+            auto first_set_bit() const -> int
+            {
+                return bit_kernels::first_set_bit(_bits.data(), _bits.size());
+            }
+
+            /**
+             * Return the index of the last set ('on') bit, or -1 if we are
+             * empty.
+             */
+            auto last_set_bit() const -> int
+            {
+                for (int i = _bits.size() - 1 ; i >= 0 ; --i) {
+                    if (0 == _bits[i])
+                        continue;
+
+                    int b = __builtin_clzll(_bits[i]);
+                    return (i + 1) * bits_per_word - b - 1;
+                }
+                return -1;
+            }
+
+            auto operator== (const DynamicBitSet & other) const -> bool
+            {
+                return _bits == other._bits;
+            }
+    };
+
+    /**
+     * A bitgraph whose size is decided at runtime. Provides the same
+     * operations as FixedBitGraph, with the intersect_with_row family taking
+     * either a DynamicBitSet or a WordRangeBitSet<dynamic_words>.
+     *
+     * Indices start at 0.
+     */
+    class DynamicBitGraph
+    {
+        private:
+            using Rows = std::vector<DynamicBitSet>;
+
+            int _size = 0;
+            Rows _adjacency;
+
+        public:
+            /**
+             * Return the actual size.
+             */
+            auto size() const -> int
+            {
+                return _size;
+            }
+
+            /**
+             * Change our size. Must be called before adding an edge, and must
+             * not be called afterwards.
+             */
+            auto resize(int size) -> void
+            {
+                _size = size;
+                _adjacency.resize(size);
+                for (auto & row : _adjacency)
+                    row.resize(size);
+            }
+
+            /**
+             * Add an edge from a to b (and from b to a).
+             */
+            auto add_edge(int a, int b) -> void
+            {
+                _adjacency[a].set(b);
+                _adjacency[b].set(a);
+            }
+
+            /**
+             * Add an edge from a to b (and from b to a).
+             */
+            auto add_edge_atomic(int a, int b) -> void
+            {
+                _adjacency[a].set_atomic(b);
+                _adjacency[b].set_atomic(a);
+            }
+
+            /**
+             * Add an edge from a to b, but not from b to a. For building a
+             * row at a time, see encode_bit_graph(); the caller is
+             * responsible for keeping things symmetric.
+             */
+            auto add_arc(int a, int b) -> void
+            {
+                _adjacency[a].set(b);
+            }
+
+            /**
+             * Are vertices a and b adjacent?
+             */
+            auto adjacent(int a, int b) const -> bool
+            {
+                return _adjacency[a].test(b);
+            }
+
+            /**
+             * What is the degree of a given vertex?
+             */
+            auto degree(int a) const -> int
+            {
+                return _adjacency[a].popcount();
+            }
+
+            /**
+             * Intersect the supplied bitset with a particular row.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row(int row, BitSet_ & p) const -> void
+            {
+                p.intersect_with(_adjacency[row]);
+            }
+
+            /**
+             * Intersect the supplied bitset with a particular row, and return
+             * how many bits it has left.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_and_popcount(int row, BitSet_ & p) const -> unsigned
+            {
+                return p.intersect_with_and_popcount(_adjacency[row]);
+            }
+
+            /**
+             * Intersect the supplied bitset with a particular row, and return
+             * whether it is now empty.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_and_test_empty(int row, BitSet_ & p) const -> bool
+            {
+                return p.intersect_with_and_test_empty(_adjacency[row]);
+            }
+
+            /**
+             * Return the first vertex at or after from which is in p and
+             * adjacent to a particular vertex, or -1. p is not changed.
+             */
+            auto first_common_bit_with_row(int row, const DynamicBitSet & p, int from = 0) const -> int
+            {
+                return _adjacency[row].first_common_bit(p, from);
+            }
+
+            /**
+             * Intersect the supplied bitset with the complement of a
+             * particular row.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_complement(int row, BitSet_ & p) const -> void
+            {
+                p.intersect_with_complement(_adjacency[row]);
+            }
+
+            /**
+             * Intersect the supplied bitset with the complement of a
+             * particular row, and return whether it is now empty.
+             */
+            template <typename BitSet_>
+            auto intersect_with_row_complement_and_test_empty(int row, BitSet_ & p) const -> bool
+            {
+                p.intersect_with_complement(_adjacency[row]);
+                return p.empty();
+            }
+
+            /**
+             * Pack the neighbours of a particular vertex which are in p
+             * into result, numbering them by where they come in p (see
+             * WordRangeBitSet::pack).
+             */
+            template <typename BitSet_, typename Result_>
+            auto pack_row(int row, const BitSet_ & p, Result_ & result) const -> void
+            {
+                p.pack(_adjacency[row], result);
+            }
+
+            /**
+             * Fetch the neighbourhood of a particular vertex.
+             */
+            auto neighbourhood(int vertex) const -> DynamicBitSet
+            {
+                return _adjacency[vertex];
+            }
+
+            /**
+             * Complement.
+             */
+            auto complement() -> void
+            {
+                for (int i = 0 ; i < _size ; ++i)
+                    _adjacency[i].complement_up_to(_size);
+            }
+    };
+
+    /**
+     * Algorithms which can work with either fixed or dynamic sized bitsets
+     * are instantiated with this many words to get the dynamic ones.
+     */
+    static const constexpr unsigned dynamic_words = 0;
+
+    /**
+     * FixedBitSet<words_>, or DynamicBitSet if words_ is dynamic_words.
+     */
+    template <unsigned words_>
+    using BitSet = typename std::conditional<dynamic_words == words_, DynamicBitSet, FixedBitSet<words_> >::type;
+
+    /**
+     * FixedBitGraph<words_>, or DynamicBitGraph if words_ is dynamic_words.
+     */
+    template <unsigned words_>
+    using BitGraph = typename std::conditional<dynamic_words == words_, DynamicBitGraph, FixedBitGraph<words_> >::type;
+
+    /**
+     * An array with one entry per possible vertex of a BitGraph<words_>.
+     * Dynamic ones must be given a size using resize_vertex_array().
+     */
+    template <unsigned words_, typename T_>
+    using VertexArray = typename std::conditional<dynamic_words == words_, std::vector<T_>, std::array<T_, words_ * bits_per_word> >::type;
+
+    /**
+     * Make sure a VertexArray has room for size entries.
+     */
+    template <typename T_, std::size_t n_>
+    auto resize_vertex_array(std::array<T_, n_> &, int) -> void
+    {
+    }
+
+    /**
+     * Make sure a VertexArray has room for size entries.
+     */
+    template <typename T_>
+    auto resize_vertex_array(std::vector<T_> & a, int size) -> void
+    {
+        a.resize(size);
+    }
+
+    /**
+     * Storage for WordRangeBitSet. Deliberately left uninitialised: only the
+     * words the set says are live mean anything.
+     */
+    template <unsigned words_>
+    class WordRangeStorage
+    {
+        private:
+            BitWord _words[words_];
+
+        public:
+            WordRangeStorage() = default;
+
+            /* Copying doesn't copy any words: WordRangeBitSet copies the ones
+             * it cares about itself. */
+
+            WordRangeStorage(const WordRangeStorage &)
+            {
+            }
+
+            auto operator= (const WordRangeStorage &) -> WordRangeStorage &
+            {
+                return *this;
+            }
+
+            auto resize(int) -> void
+            {
+            }
+
+            auto number_of_words() const -> unsigned
+            {
+                return words_;
+            }
+
+            auto data() -> BitWord *
+            {
+                return _words;
+            }
+
+            auto data() const -> const BitWord *
+            {
+                return _words;
+            }
+    };
+
+    template <>
+    class WordRangeStorage<dynamic_words>
+    {
+        private:
+            unsigned _n = 0;
+            std::unique_ptr<BitWord[], void (*)(void *)> _words{ nullptr, std::free };
+
+        public:
+            WordRangeStorage() = default;
+
+            WordRangeStorage(const WordRangeStorage & other)
+            {
+                resize(other._n * bits_per_word);
+            }
+
+            WordRangeStorage(WordRangeStorage &&) = default;
+
+            auto operator= (const WordRangeStorage & other) -> WordRangeStorage &
+            {
+                if (_n != other._n)
+                    resize(other._n * bits_per_word);
+                return *this;
+            }
+
+            auto operator= (WordRangeStorage &&) -> WordRangeStorage & = default;
+
+            auto resize(int size) -> void
+            {
+                _n = (size + bits_per_word - 1) / bits_per_word;
+                _words.reset(CacheLineAlignedAllocator<BitWord>().allocate(_n));
+            }
+
+            auto number_of_words() const -> unsigned
+            {
+                return _n;
+            }
+
+            auto data() -> BitWord *
+            {
+                return _words.get();
+            }
+
+            auto data() const -> const BitWord *
+            {
+                return _words.get();
+            }
+    };
+
+    /**
+     * A bitset which keeps track of which of its words could be non-zero,
+     * and only ever looks at those. Deep in the search our candidate sets
+     * usually only have a few bits left, so this is much cheaper than
+     * walking every word of a BitSet<words_>. Provides the operations on
+     * FixedBitSet that a search's candidate set needs, and anything it is
+     * intersected with must be a BitSet<words_>. The range only grows when
+     * set() is used.
+     *
+     * Indices start at 0.
+     */
+    template <unsigned words_>
+    class WordRangeBitSet
+    {
+        private:
+            WordRangeStorage<words_> _words;
+
+            /* Every non-zero word is in [_first_word, _end_word), and nothing
+             * outside that range has been initialised. Unsetting bits doesn't
+             * bother updating this, so the range is tightened lazily. */
+            mutable unsigned _first_word = 0, _end_word = 0;
+
+            /* How many words are in our range? This also tells the compiler
+             * that the range is in bounds, which it can't work out for
+             * itself, and which otherwise gets us bogus warnings. */
+            auto _live_words() const -> unsigned
+            {
+                if (_end_word > _words.number_of_words() || _first_word > _end_word)
+                    __builtin_unreachable();
+                return _end_word - _first_word;
+            }
+
+            auto _tighten_first() const -> void
+            {
+                const BitWord * w = _words.data();
+                while (_first_word < _end_word && 0 == w[_first_word])
+                    ++_first_word;
+            }
+
+            auto _tighten_end() const -> void
+            {
+                const BitWord * w = _words.data();
+                while (_end_word > _first_word && 0 == w[_end_word - 1])
+                    --_end_word;
+            }
+
+        public:
+            WordRangeBitSet() = default;
+
+            WordRangeBitSet(const WordRangeBitSet & other) :
+                _words(other._words),
+                _first_word(other._first_word),
+                _end_word(other._end_word)
+            {
+                std::copy(other._words.data() + _first_word, other._words.data() + _end_word, _words.data() + _first_word);
+            }
+
+            auto operator= (const WordRangeBitSet & other) -> WordRangeBitSet &
+            {
+                _words = other._words;
+                _first_word = other._first_word;
+                _end_word = other._end_word;
+                std::copy(other._words.data() + _first_word, other._words.data() + _end_word, _words.data() + _first_word);
+                return *this;
+            }
+
+            /**
+             * Make sure we can hold size bits. Throws away any bits we
+             * already have.
+             */
+            auto resize(int size) -> void
+            {
+                _words.resize(size);
+                _first_word = _end_word = 0;
+            }
+
+            /**
+             * Set a given bit 'on'.
+             */
+            auto set(int a) -> void
+            {
+                unsigned w = a / bits_per_word;
+                if (_first_word == _end_word) {
+                    _first_word = w;
+                    _end_word = w + 1;
+                    _words.data()[w] = 0;
+                }
+                else {
+                    for ( ; w < _first_word ; --_first_word)
+                        _words.data()[_first_word - 1] = 0;
+                    for ( ; w >= _end_word ; ++_end_word)
+                        _words.data()[_end_word] = 0;
+                }
+
+                _words.data()[w] |= (BitWord{ 1 } << (a % bits_per_word));
+            }
+
+            /**
+             * Set a given bit 'off'.
+             */
+            auto unset(int a) -> void
+            {
+                unsigned w = a / bits_per_word;
+                if (w >= _first_word && w < _end_word)
+                    _words.data()[w] &= ~(BitWord{ 1 } << (a % bits_per_word));
+            }
+
+            /**
+             * Set all bits on.
+             */
+            auto set_up_to(int size) -> void
+            {
+                _first_word = 0;
+                _end_word = (size + bits_per_word - 1) / bits_per_word;
+                std::fill(_words.data(), _words.data() + _end_word, ~BitWord{ 0 });
+                if (0 != size % bits_per_word)
+                    _words.data()[_end_word - 1] = (BitWord{ 1 } << (size % bits_per_word)) - 1;
+            }
+
+            /**
+             * Set all bits off.
+             */
+            auto unset_all() -> void
+            {
+                _first_word = _end_word = 0;
+            }
+
+            /**
+             * Is a given bit on?
+             */
+            auto test(int a) const -> bool
+            {
+                unsigned w = a / bits_per_word;
+                return w >= _first_word && w < _end_word && (_words.data()[w] & (BitWord{ 1 } << (a % bits_per_word)));
+            }
+
+            /**
+             * How many bits are on?
+             */
+            auto popcount() const -> unsigned
+            {
+                return bit_kernels::popcount(_words.data() + _first_word, _live_words());
+            }
+
+            /**
+             * Are any bits on?
+             */
+            auto empty() const -> bool
+            {
+                _tighten_first();
+                return _first_word == _end_word;
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set.
+             */
+            auto intersect_with(const BitSet<words_> & other) -> void
+            {
+                bit_kernels::intersect(_words.data() + _first_word, other.data() + _first_word, _live_words());
+                _tighten_first();
+                _tighten_end();
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return how many
+             * bits are on afterwards.
+             */
+            auto intersect_with_and_popcount(const BitSet<words_> & other) -> unsigned
+            {
+                unsigned result = bit_kernels::intersect_and_popcount(_words.data() + _first_word, other.data() + _first_word, _live_words());
+                if (0 == result)
+                    _first_word = _end_word = 0;
+                else {
+                    _tighten_first();
+                    _tighten_end();
+                }
+                return result;
+            }
+
+            /**
+             * Intersect (bitwise-and) with another set, and return whether we
+             * are now empty.
+             */
+            auto intersect_with_and_test_empty(const BitSet<words_> & other) -> bool
+            {
+                if (bit_kernels::intersect_and_test_empty(_words.data() + _first_word, other.data() + _first_word, _live_words())) {
+                    _first_word = _end_word = 0;
+                    return true;
+                }
+                else {
+                    _tighten_first();
+                    _tighten_end();
+                    return false;
+                }
+            }
+
+            /**
+             * Intersect with the complement of another set.
+             */
+            auto intersect_with_complement(const BitSet<words_> & other) -> void
+            {
+                bit_kernels::intersect_complement(_words.data() + _first_word, other.data() + _first_word, _live_words());
+                _tighten_first();
+                _tighten_end();
+            }
+
+            /**
+             * Return the index of the first set ('on') bit, or -1 if we are
+             * empty.
+             */
+            auto first_set_bit() const -> int
+            {
+                _tighten_first();
+                if (_first_word == _end_word)
+                    return -1;
+                return _first_word * bits_per_word + __builtin_ctzll(_words.data()[_first_word]);
+            }
+
+            /**
+             * Return the index of the last set ('on') bit, or -1 if we are
+             * empty.
+             */
+            auto last_set_bit() const -> int
+            {
+                _tighten_end();
+                if (_first_word == _end_word)
+                    return -1;
+                return (_end_word * bits_per_word) - __builtin_clzll(_words.data()[_end_word - 1]) - 1;
+            }
+
+            /**
+             * Pack the bits of row which are at positions we have on into
+             * result, so result's ith bit is row's bit at our ith on bit.
+             * result must start off empty.
+             */
+            template <typename Result_>
+            auto pack(const BitSet<words_> & row, Result_ & result) const -> void
+            {
+                bit_kernels::pack(row.data() + _first_word, _words.data() + _first_word, _live_words(), result.data());
+            }
+    };
+
+    /// Below this many words, keeping track of the live range isn't worth it.
+    static const constexpr unsigned word_range_min_words = 8;
+
+    /**
+     * WordRangeBitSet<words_>, or plain BitSet<words_> if words_ is too small
+     * for range tracking to help.
+     */
+    template <unsigned words_>
+    using RangedBitSet = typename std::conditional<dynamic_words == words_ || words_ >= word_range_min_words,
+          WordRangeBitSet<words_>, BitSet<words_> >::type;
+
     /**
      * We have to decide at compile time what the largest graph we'll support
      * is.
@@ -301,7 +1229,8 @@ namespace parasols
     constexpr auto max_graph_words __attribute__((unused)) = 1024;
 
     /**
-     * Thrown if we exceed max_graph_words.
+     * Thrown if we exceed max_graph_words, for algorithms which don't support
+     * DynamicBitGraph.
      */
     class GraphTooBig :
         public std::exception
@@ -0,0 +1,574 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_GRAPH_BIT_KERNELS_HH
+#define PARASOLS_GUARD_GRAPH_BIT_KERNELS_HH 1
+
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && (defined(__AVX2__) || defined(__AVX512F__) || defined(__BMI2__))
+#  include <immintrin.h>
+#endif
+
+namespace parasols
+{
+    /// We'll use an array of unsigned long longs to represent our bits.
+    using BitWord = unsigned long long;
+
+    /// Number of bits per word.
+    static const constexpr int bits_per_word = sizeof(BitWord) * 8;
+
+    /**
+     * The word-at-a-time loops behind FixedBitSet and DynamicBitSet. Each
+     * kernel works on n words, with a being updated in place where that makes
+     * sense.
+     *
+     * Which vectorised versions exist depends upon what the compiler has been
+     * told it can use (we build with -march=native). Defining
+     * PARASOLS_BIT_KERNELS_SCALAR forces the scalar versions everywhere.
+     */
+    namespace bit_kernels
+    {
+        namespace scalar
+        {
+            inline auto intersect(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                for (unsigned i = 0 ; i < n ; ++i)
+                    a[i] &= b[i];
+            }
+
+            inline auto intersect_complement(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                for (unsigned i = 0 ; i < n ; ++i)
+                    a[i] &= ~b[i];
+            }
+
+            inline auto popcount(const BitWord * a, unsigned n) -> unsigned
+            {
+                unsigned result = 0;
+                for (unsigned i = 0 ; i < n ; ++i)
+                    result += __builtin_popcountll(a[i]);
+                return result;
+            }
+
+            inline auto empty(const BitWord * a, unsigned n) -> bool
+            {
+                for (unsigned i = 0 ; i < n ; ++i)
+                    if (0 != a[i])
+                        return false;
+                return true;
+            }
+
+            inline auto first_set_bit(const BitWord * a, unsigned n) -> int
+            {
+                for (unsigned i = 0 ; i < n ; ++i) {
+                    int b = __builtin_ffsll(a[i]);
+                    if (0 != b)
+                        return i * bits_per_word + b - 1;
+                }
+                return -1;
+            }
+
+            inline auto intersect_and_popcount(BitWord * a, const BitWord * b, unsigned n) -> unsigned
+            {
+                unsigned result = 0;
+                for (unsigned i = 0 ; i < n ; ++i) {
+                    a[i] &= b[i];
+                    result += __builtin_popcountll(a[i]);
+                }
+                return result;
+            }
+
+            inline auto first_common_bit(const BitWord * a, const BitWord * b, unsigned n) -> int
+            {
+                for (unsigned i = 0 ; i < n ; ++i) {
+                    BitWord common = a[i] & b[i];
+                    if (0 != common)
+                        return i * bits_per_word + __builtin_ctzll(common);
+                }
+                return -1;
+            }
+
+            inline auto intersect_and_test_empty(BitWord * a, const BitWord * b, unsigned n) -> bool
+            {
+                BitWord any = 0;
+                for (unsigned i = 0 ; i < n ; ++i) {
+                    a[i] &= b[i];
+                    any |= a[i];
+                }
+                return 0 == any;
+            }
+        }
+
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX2__)
+        namespace avx2
+        {
+            /// Words per vector.
+            static const constexpr unsigned lanes = 4;
+
+            inline auto load(const BitWord * a) -> __m256i
+            {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+            }
+
+            inline auto store(BitWord * a, __m256i v) -> void
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), v);
+            }
+
+            /**
+             * Per-64-bit-lane popcounts, using a nibble lookup table (there
+             * isn't a popcount instruction until AVX-512).
+             */
+            inline auto popcount_lanes(__m256i v) -> __m256i
+            {
+                const __m256i lookup = _mm256_setr_epi8(
+                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+                const __m256i low_mask = _mm256_set1_epi8(0x0f);
+                __m256i lo = _mm256_and_si256(v, low_mask);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+                __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+                return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+            }
+
+            inline auto sum_lanes(__m256i v) -> unsigned
+            {
+                __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+            }
+
+            inline auto intersect(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                unsigned i = 0;
+                for ( ; i + lanes <= n ; i += lanes)
+                    store(a + i, _mm256_and_si256(load(a + i), load(b + i)));
+                scalar::intersect(a + i, b + i, n - i);
+            }
+
+            inline auto intersect_complement(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                unsigned i = 0;
+                for ( ; i + lanes <= n ; i += lanes)
+                    store(a + i, _mm256_andnot_si256(load(b + i), load(a + i)));
+                scalar::intersect_complement(a + i, b + i, n - i);
+            }
+
+            inline auto popcount(const BitWord * a, unsigned n) -> unsigned
+            {
+                unsigned i = 0;
+                __m256i acc = _mm256_setzero_si256();
+                for ( ; i + lanes <= n ; i += lanes)
+                    acc = _mm256_add_epi64(acc, popcount_lanes(load(a + i)));
+                return sum_lanes(acc) + scalar::popcount(a + i, n - i);
+            }
+
+            inline auto empty(const BitWord * a, unsigned n) -> bool
+            {
+                unsigned i = 0;
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m256i v = load(a + i);
+                    if (! _mm256_testz_si256(v, v))
+                        return false;
+                }
+                return scalar::empty(a + i, n - i);
+            }
+
+            inline auto first_set_bit(const BitWord * a, unsigned n) -> int
+            {
+                unsigned i = 0;
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m256i v = load(a + i);
+                    if (! _mm256_testz_si256(v, v))
+                        return i * bits_per_word + scalar::first_set_bit(a + i, lanes);
+                }
+                int b = scalar::first_set_bit(a + i, n - i);
+                return -1 == b ? -1 : i * bits_per_word + b;
+            }
+
+            inline auto intersect_and_popcount(BitWord * a, const BitWord * b, unsigned n) -> unsigned
+            {
+                unsigned i = 0;
+                __m256i acc = _mm256_setzero_si256();
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m256i v = _mm256_and_si256(load(a + i), load(b + i));
+                    store(a + i, v);
+                    acc = _mm256_add_epi64(acc, popcount_lanes(v));
+                }
+                return sum_lanes(acc) + scalar::intersect_and_popcount(a + i, b + i, n - i);
+            }
+
+            inline auto intersect_and_test_empty(BitWord * a, const BitWord * b, unsigned n) -> bool
+            {
+                unsigned i = 0;
+                __m256i any = _mm256_setzero_si256();
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m256i v = _mm256_and_si256(load(a + i), load(b + i));
+                    store(a + i, v);
+                    any = _mm256_or_si256(any, v);
+                }
+                bool rest_empty = scalar::intersect_and_test_empty(a + i, b + i, n - i);
+                return rest_empty && _mm256_testz_si256(any, any);
+            }
+        }
+#endif
+
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX512F__)
+/* When these are inlined on a sub-range of a fixed sized array, GCC can't
+ * tell that the loop bounds keep us inside it, and warns spuriously. */
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Warray-bounds"
+        namespace avx512
+        {
+            /// Words per vector.
+            static const constexpr unsigned lanes = 8;
+
+            inline auto load(const BitWord * a) -> __m512i
+            {
+                return _mm512_loadu_si512(a);
+            }
+
+            inline auto store(BitWord * a, __m512i v) -> void
+            {
+                _mm512_storeu_si512(a, v);
+            }
+
+            /**
+             * Whatever is left over at the end is handled using masked loads
+             * and stores, rather than a scalar loop.
+             */
+            inline auto tail_mask(unsigned n) -> __mmask8
+            {
+                return __mmask8((1u << n) - 1);
+            }
+
+            inline auto load(const BitWord * a, __mmask8 m) -> __m512i
+            {
+                return _mm512_maskz_loadu_epi64(m, a);
+            }
+
+            inline auto store(BitWord * a, __mmask8 m, __m512i v) -> void
+            {
+                _mm512_mask_storeu_epi64(a, m, v);
+            }
+
+            /**
+             * Sum the 64-bit lanes. We don't use _mm512_reduce_add_epi64,
+             * because older GCCs give bogus maybe-uninitialized warnings
+             * for it.
+             */
+            inline auto sum_lanes(__m512i v) -> unsigned
+            {
+                alignas(64) BitWord w[lanes];
+                _mm512_store_si512(w, v);
+                return w[0] + w[1] + w[2] + w[3] + w[4] + w[5] + w[6] + w[7];
+            }
+
+            /**
+             * a & ~b, avoiding _mm512_andnot_si512 for the same reason.
+             */
+            inline auto and_not(__m512i a, __m512i b) -> __m512i
+            {
+                return _mm512_ternarylogic_epi64(a, b, b, 0x30);
+            }
+
+            /* The straight-line loops are unrolled four vectors at a time,
+             * with independent accumulators, or we lose to what the compiler
+             * does with the scalar versions. */
+
+            inline auto intersect(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                unsigned i = 0;
+                for ( ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    __m512i v0 = _mm512_and_si512(load(a + i), load(b + i));
+                    __m512i v1 = _mm512_and_si512(load(a + i + lanes), load(b + i + lanes));
+                    __m512i v2 = _mm512_and_si512(load(a + i + 2 * lanes), load(b + i + 2 * lanes));
+                    __m512i v3 = _mm512_and_si512(load(a + i + 3 * lanes), load(b + i + 3 * lanes));
+                    store(a + i, v0);
+                    store(a + i + lanes, v1);
+                    store(a + i + 2 * lanes, v2);
+                    store(a + i + 3 * lanes, v3);
+                }
+                for ( ; i + lanes <= n ; i += lanes)
+                    store(a + i, _mm512_and_si512(load(a + i), load(b + i)));
+                if (i != n) {
+                    __mmask8 m = tail_mask(n - i);
+                    store(a + i, m, _mm512_and_si512(load(a + i, m), load(b + i, m)));
+                }
+            }
+
+            inline auto intersect_complement(BitWord * a, const BitWord * b, unsigned n) -> void
+            {
+                unsigned i = 0;
+                for ( ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    __m512i v0 = and_not(load(a + i), load(b + i));
+                    __m512i v1 = and_not(load(a + i + lanes), load(b + i + lanes));
+                    __m512i v2 = and_not(load(a + i + 2 * lanes), load(b + i + 2 * lanes));
+                    __m512i v3 = and_not(load(a + i + 3 * lanes), load(b + i + 3 * lanes));
+                    store(a + i, v0);
+                    store(a + i + lanes, v1);
+                    store(a + i + 2 * lanes, v2);
+                    store(a + i + 3 * lanes, v3);
+                }
+                for ( ; i + lanes <= n ; i += lanes)
+                    store(a + i, and_not(load(a + i), load(b + i)));
+                if (i != n) {
+                    __mmask8 m = tail_mask(n - i);
+                    store(a + i, m, and_not(load(a + i, m), load(b + i, m)));
+                }
+            }
+
+#if defined(__AVX512VPOPCNTDQ__)
+            inline auto popcount(const BitWord * a, unsigned n) -> unsigned
+            {
+                unsigned i = 0;
+                __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512(),
+                        acc2 = _mm512_setzero_si512(), acc3 = _mm512_setzero_si512();
+                for ( ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    acc0 = _mm512_add_epi64(acc0, _mm512_popcnt_epi64(load(a + i)));
+                    acc1 = _mm512_add_epi64(acc1, _mm512_popcnt_epi64(load(a + i + lanes)));
+                    acc2 = _mm512_add_epi64(acc2, _mm512_popcnt_epi64(load(a + i + 2 * lanes)));
+                    acc3 = _mm512_add_epi64(acc3, _mm512_popcnt_epi64(load(a + i + 3 * lanes)));
+                }
+                for ( ; i + lanes <= n ; i += lanes)
+                    acc0 = _mm512_add_epi64(acc0, _mm512_popcnt_epi64(load(a + i)));
+                if (i != n)
+                    acc1 = _mm512_add_epi64(acc1, _mm512_popcnt_epi64(load(a + i, tail_mask(n - i))));
+                return sum_lanes(_mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3)));
+            }
+#else
+            /* Without VPOPCNTQ, we may as well stick with AVX2. */
+            using avx2::popcount;
+#endif
+
+            inline auto empty(const BitWord * a, unsigned n) -> bool
+            {
+                unsigned i = 0;
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m512i v = load(a + i);
+                    if (0 != _mm512_test_epi64_mask(v, v))
+                        return false;
+                }
+                if (i != n) {
+                    __m512i v = load(a + i, tail_mask(n - i));
+                    if (0 != _mm512_test_epi64_mask(v, v))
+                        return false;
+                }
+                return true;
+            }
+
+            inline auto first_set_bit(const BitWord * a, unsigned n) -> int
+            {
+                unsigned i = 0, nonzero = 0;
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m512i v = load(a + i);
+                    nonzero = _mm512_test_epi64_mask(v, v);
+                    if (0 != nonzero)
+                        break;
+                }
+                if (0 == nonzero && i != n) {
+                    __m512i v = load(a + i, tail_mask(n - i));
+                    nonzero = _mm512_test_epi64_mask(v, v);
+                }
+                if (0 == nonzero)
+                    return -1;
+
+                unsigned w = i + __builtin_ctz(nonzero);
+                return w * bits_per_word + __builtin_ctzll(a[w]);
+            }
+
+#if defined(__AVX512VPOPCNTDQ__)
+            inline auto intersect_and_popcount(BitWord * a, const BitWord * b, unsigned n) -> unsigned
+            {
+                unsigned i = 0;
+                __m512i acc0 = _mm512_setzero_si512(), acc1 = _mm512_setzero_si512(),
+                        acc2 = _mm512_setzero_si512(), acc3 = _mm512_setzero_si512();
+                for ( ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    __m512i v0 = _mm512_and_si512(load(a + i), load(b + i));
+                    __m512i v1 = _mm512_and_si512(load(a + i + lanes), load(b + i + lanes));
+                    __m512i v2 = _mm512_and_si512(load(a + i + 2 * lanes), load(b + i + 2 * lanes));
+                    __m512i v3 = _mm512_and_si512(load(a + i + 3 * lanes), load(b + i + 3 * lanes));
+                    store(a + i, v0);
+                    store(a + i + lanes, v1);
+                    store(a + i + 2 * lanes, v2);
+                    store(a + i + 3 * lanes, v3);
+                    acc0 = _mm512_add_epi64(acc0, _mm512_popcnt_epi64(v0));
+                    acc1 = _mm512_add_epi64(acc1, _mm512_popcnt_epi64(v1));
+                    acc2 = _mm512_add_epi64(acc2, _mm512_popcnt_epi64(v2));
+                    acc3 = _mm512_add_epi64(acc3, _mm512_popcnt_epi64(v3));
+                }
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m512i v = _mm512_and_si512(load(a + i), load(b + i));
+                    store(a + i, v);
+                    acc0 = _mm512_add_epi64(acc0, _mm512_popcnt_epi64(v));
+                }
+                if (i != n) {
+                    __mmask8 m = tail_mask(n - i);
+                    __m512i v = _mm512_and_si512(load(a + i, m), load(b + i, m));
+                    store(a + i, m, v);
+                    acc1 = _mm512_add_epi64(acc1, _mm512_popcnt_epi64(v));
+                }
+                return sum_lanes(_mm512_add_epi64(_mm512_add_epi64(acc0, acc1), _mm512_add_epi64(acc2, acc3)));
+            }
+#else
+            using avx2::intersect_and_popcount;
+#endif
+
+            inline auto intersect_and_test_empty(BitWord * a, const BitWord * b, unsigned n) -> bool
+            {
+                unsigned i = 0;
+                __m512i any0 = _mm512_setzero_si512(), any1 = _mm512_setzero_si512();
+                for ( ; i + 4 * lanes <= n ; i += 4 * lanes) {
+                    __m512i v0 = _mm512_and_si512(load(a + i), load(b + i));
+                    __m512i v1 = _mm512_and_si512(load(a + i + lanes), load(b + i + lanes));
+                    __m512i v2 = _mm512_and_si512(load(a + i + 2 * lanes), load(b + i + 2 * lanes));
+                    __m512i v3 = _mm512_and_si512(load(a + i + 3 * lanes), load(b + i + 3 * lanes));
+                    store(a + i, v0);
+                    store(a + i + lanes, v1);
+                    store(a + i + 2 * lanes, v2);
+                    store(a + i + 3 * lanes, v3);
+                    any0 = _mm512_ternarylogic_epi64(any0, v0, v1, 0xfe);
+                    any1 = _mm512_ternarylogic_epi64(any1, v2, v3, 0xfe);
+                }
+                for ( ; i + lanes <= n ; i += lanes) {
+                    __m512i v = _mm512_and_si512(load(a + i), load(b + i));
+                    store(a + i, v);
+                    any0 = _mm512_or_si512(any0, v);
+                }
+                if (i != n) {
+                    __mmask8 m = tail_mask(n - i);
+                    __m512i v = _mm512_and_si512(load(a + i, m), load(b + i, m));
+                    store(a + i, m, v);
+                    any1 = _mm512_or_si512(any1, v);
+                }
+                return 0 == _mm512_test_epi64_mask(any0, any0) && 0 == _mm512_test_epi64_mask(any1, any1);
+            }
+        }
+#  pragma GCC diagnostic pop
+#endif
+
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX512F__)
+        namespace selected = avx512;
+        static const constexpr unsigned selected_lanes = avx512::lanes;
+#elif ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX2__)
+        namespace selected = avx2;
+        static const constexpr unsigned selected_lanes = avx2::lanes;
+#else
+        namespace selected = scalar;
+        static const constexpr unsigned selected_lanes = 1;
+#endif
+
+        /* What the bitsets call. Anything shorter than a vector is left to
+         * the scalar versions, which for fixed sizes get unrolled
+         * completely. */
+
+        inline auto intersect(BitWord * a, const BitWord * b, unsigned n) -> void
+        {
+            if (n < selected_lanes)
+                scalar::intersect(a, b, n);
+            else
+                selected::intersect(a, b, n);
+        }
+
+        inline auto intersect_complement(BitWord * a, const BitWord * b, unsigned n) -> void
+        {
+            if (n < selected_lanes)
+                scalar::intersect_complement(a, b, n);
+            else
+                selected::intersect_complement(a, b, n);
+        }
+
+        inline auto popcount(const BitWord * a, unsigned n) -> unsigned
+        {
+            if (n < selected_lanes)
+                return scalar::popcount(a, n);
+            else
+                return selected::popcount(a, n);
+        }
+
+        inline auto empty(const BitWord * a, unsigned n) -> bool
+        {
+            if (n < selected_lanes)
+                return scalar::empty(a, n);
+            else
+                return selected::empty(a, n);
+        }
+
+        inline auto first_set_bit(const BitWord * a, unsigned n) -> int
+        {
+            if (n < selected_lanes)
+                return scalar::first_set_bit(a, n);
+            else
+                return selected::first_set_bit(a, n);
+        }
+
+        inline auto intersect_and_popcount(BitWord * a, const BitWord * b, unsigned n) -> unsigned
+        {
+            if (n < selected_lanes)
+                return scalar::intersect_and_popcount(a, b, n);
+            else
+                return selected::intersect_and_popcount(a, b, n);
+        }
+
+        inline auto intersect_and_test_empty(BitWord * a, const BitWord * b, unsigned n) -> bool
+        {
+            if (n < selected_lanes)
+                return scalar::intersect_and_test_empty(a, b, n);
+            else
+                return selected::intersect_and_test_empty(a, b, n);
+        }
+
+        /* This one usually stops within the first few words, so there's
+         * nothing to gain from a vector version. */
+
+        inline auto first_common_bit(const BitWord * a, const BitWord * b, unsigned n) -> int
+        {
+            return scalar::first_common_bit(a, b, n);
+        }
+
+        /**
+         * Pack the bits of a which are at positions on in mask together into
+         * out, in order, so out's ith bit is a's bit at mask's ith on bit.
+         * Only sets bits, so out should start off zeroed. This is pext where
+         * we have it, and a bit at a time otherwise.
+         */
+        inline auto pack(const BitWord * a, const BitWord * mask, unsigned n, BitWord * out) -> void
+        {
+            unsigned at = 0;
+            for (unsigned i = 0 ; i < n ; ++i) {
+                BitWord m = mask[i];
+                if (0 == m)
+                    continue;
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__BMI2__)
+                BitWord bits = _pext_u64(a[i], m);
+                unsigned k = __builtin_popcountll(m);
+#else
+                BitWord bits = 0;
+                unsigned k = 0;
+                for ( ; 0 != m ; m &= m - 1, ++k)
+                    if (a[i] & m & -m)
+                        bits |= BitWord{ 1 } << k;
+#endif
+                out[at / bits_per_word] |= bits << (at % bits_per_word);
+                if (0 != at % bits_per_word && at % bits_per_word + k > unsigned(bits_per_word))
+                    out[at / bits_per_word + 1] |= bits >> (bits_per_word - at % bits_per_word);
+                at += k;
+            }
+        }
+
+        /**
+         * Which kernels have we been built with?
+         */
+        inline auto selected_name() -> const char *
+        {
+#if ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+            return "avx512 vpopcntq";
+#elif ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX512F__)
+            return "avx512";
+#elif ! defined(PARASOLS_BIT_KERNELS_SCALAR) && defined(__AVX2__)
+            return "avx2";
+#else
+            return "scalar";
+#endif
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,154 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_GRAPH_DEGREE_BUCKET_QUEUE_HH
+#define PARASOLS_GUARD_GRAPH_DEGREE_BUCKET_QUEUE_HH 1
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace parasols
+{
+    /**
+     * A bucket queue of vertices, keyed on a degree which only ever goes
+     * down, with ties broken on a second key, smallest first. This is what
+     * the degeneracy-style orders need: removing a vertex only changes the
+     * keys of vertices near it, so we shouldn't have to look at everything
+     * to find the next one.
+     *
+     * Each bucket is a heap on the tiebreak. Changing a key pushes a fresh
+     * entry, and out of date entries are thrown away when they reach the
+     * top of their bucket.
+     *
+     * Indices start at 0.
+     */
+    template <typename Tiebreak_>
+    class DegreeBucketQueue
+    {
+        private:
+            using Entry = std::pair<Tiebreak_, int>;
+            using Order = std::greater<Entry>;
+
+            std::vector<std::vector<Entry> > _buckets;
+            std::vector<int> _degrees;
+            std::vector<Tiebreak_> _tiebreaks;
+            std::vector<bool> _present;
+            int _lowest, _highest;
+
+            auto _push(int v) -> void
+            {
+                auto & bucket = _buckets[_degrees[v]];
+                bucket.emplace_back(_tiebreaks[v], v);
+                std::push_heap(bucket.begin(), bucket.end(), Order());
+                _lowest = std::min(_lowest, _degrees[v]);
+                _highest = std::max(_highest, _degrees[v]);
+            }
+
+            /**
+             * Throw away out of date entries from the top of a bucket, and
+             * return whether it has anything left.
+             */
+            auto _clean(int d) -> bool
+            {
+                auto & bucket = _buckets[d];
+                while (! bucket.empty()) {
+                    const Entry & top = bucket.front();
+                    if (_present[top.second] && _degrees[top.second] == d && _tiebreaks[top.second] == top.first)
+                        return true;
+                    std::pop_heap(bucket.begin(), bucket.end(), Order());
+                    bucket.pop_back();
+                }
+                return false;
+            }
+
+            auto _take(int d) -> int
+            {
+                auto & bucket = _buckets[d];
+                int v = bucket.front().second;
+                std::pop_heap(bucket.begin(), bucket.end(), Order());
+                bucket.pop_back();
+                _present[v] = false;
+                return v;
+            }
+
+        public:
+            /**
+             * Vertices are numbered from 0 to size - 1, and have degree at
+             * most size. The queue starts off empty.
+             */
+            explicit DegreeBucketQueue(int size) :
+                _buckets(size + 1),
+                _degrees(size),
+                _tiebreaks(size),
+                _present(size, false),
+                _lowest(size + 1),
+                _highest(-1)
+            {
+            }
+
+            /**
+             * Add a vertex, or change the keys of one we already have. Its
+             * degree must not go up.
+             */
+            auto insert(int v, int degree, const Tiebreak_ & tiebreak) -> void
+            {
+                _present[v] = true;
+                _degrees[v] = degree;
+                _tiebreaks[v] = tiebreak;
+                _push(v);
+            }
+
+            /**
+             * Reduce the degree of a vertex we have by one.
+             */
+            auto decrement_degree(int v) -> void
+            {
+                --_degrees[v];
+                _push(v);
+            }
+
+            /**
+             * Is this vertex still in the queue?
+             */
+            auto contains(int v) const -> bool
+            {
+                return _present[v];
+            }
+
+            /**
+             * What is the current degree of a vertex? Still valid after it
+             * has been removed.
+             */
+            auto degree(int v) const -> int
+            {
+                return _degrees[v];
+            }
+
+            /**
+             * Remove and return the vertex with the lowest degree, or -1 if
+             * we are empty.
+             */
+            auto pop_lowest() -> int
+            {
+                for ( ; _lowest <= _highest ; ++_lowest)
+                    if (_clean(_lowest))
+                        return _take(_lowest);
+                return -1;
+            }
+
+            /**
+             * Remove and return the vertex with the highest degree, or -1 if
+             * we are empty.
+             */
+            auto pop_highest() -> int
+            {
+                for ( ; _highest >= _lowest ; --_highest)
+                    if (_clean(_highest))
+                        return _take(_highest);
+                return -1;
+            }
+    };
+}
+
+#endif
@@ -1,75 +1,104 @@
 /* vim: set sw=4 sts=4 et foldmethod=syntax : */
 
 #include <graph/degree_sort.hh>
+#include <graph/degree_bucket_queue.hh>
 
 #include <algorithm>
-#include <iterator>
+#include <atomic>
+#include <list>
+#include <thread>
 
 using namespace parasols;
 
+namespace
+{
+    /**
+     * How many rows a thread takes at once when calculating exdegrees. Also
+     * the smallest graph we'll bother using threads for.
+     */
+    const constexpr int exdegree_rows_per_chunk = 1024;
+}
+
 auto parasols::degree_sort(const Graph & graph, std::vector<int> & p, bool reverse) -> void
 {
-    // pre-calculate degrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
+    auto less = [&] (int a, int b) { return
+        graph.degree(a) < graph.degree(b) || (graph.degree(a) == graph.degree(b) && a > b); };
 
     // sort on degree
     std::sort(p.begin(), p.end(),
-            [&] (int a, int b) { return (! reverse) ^ (degrees[a] < degrees[b] || (degrees[a] == degrees[b] && a > b)); });
+            [&] (int a, int b) { return reverse ? less(a, b) : less(b, a); });
+}
+
+auto parasols::calculate_exdegrees(const Graph & graph) -> std::vector<long long>
+{
+    std::vector<long long> exdegrees((graph.size()));
+    std::atomic<int> next_chunk{ 0 };
+
+    auto calculate_rows = [&] () {
+        while (true) {
+            int first = next_chunk.fetch_add(exdegree_rows_per_chunk);
+            if (first >= graph.size())
+                break;
+
+            int last = std::min(graph.size(), first + exdegree_rows_per_chunk);
+            for (int i = first ; i < last ; ++i)
+                graph.for_each_neighbour(i, [&] (int j) { exdegrees[i] += graph.degree(j); });
+        }
+    };
+
+    unsigned n_chunks = (graph.size() + exdegree_rows_per_chunk - 1) / exdegree_rows_per_chunk;
+    unsigned n_workers = std::max(1u, std::min(std::thread::hardware_concurrency(), n_chunks));
+
+    std::list<std::thread> threads;
+    for (unsigned t = 1 ; t < n_workers ; ++t)
+        threads.push_back(std::thread(calculate_rows));
+
+    calculate_rows();
+
+    for (auto & t : threads)
+        t.join();
+
+    return exdegrees;
 }
 
 auto parasols::exdegree_sort(const Graph & graph, std::vector<int> & p, bool reverse) -> void
 {
-    // pre-calculate degrees and exdegrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
+    // pre-calculate exdegrees
+    auto exdegrees = calculate_exdegrees(graph);
 
-    std::vector<int> exdegrees((graph.size()));
-    for (int i = 0 ; i < graph.size() ; ++i)
-        for (int j = 0 ; j < graph.size() ; ++j)
-            if (graph.adjacent(i, j))
-                exdegrees[i] += degrees[j];
+    auto less = [&] (int a, int b) { return
+        (graph.degree(a) < graph.degree(b)) ||
+        (graph.degree(a) == graph.degree(b) && exdegrees[a] < exdegrees[b]) ||
+        (graph.degree(a) == graph.degree(b) && exdegrees[a] == exdegrees[b] && a > b); };
 
     // sort on degree
     std::sort(p.begin(), p.end(),
-            [&] (int a, int b) { return (! reverse) ^ (
-                (degrees[a] < degrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] < exdegrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] == exdegrees[b] && a > b)
-                ); });
+            [&] (int a, int b) { return reverse ? less(a, b) : less(b, a); });
 }
 
 auto parasols::dynexdegree_sort(const Graph & graph, std::vector<int> & p, bool reverse) -> void
 {
-    // pre-calculate degrees and exdegrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
-
-    std::vector<int> exdegrees((graph.size()));
-    for (int i = 0 ; i < graph.size() ; ++i)
-        for (int j = 0 ; j < graph.size() ; ++j)
-            if (graph.adjacent(i, j))
-                exdegrees[i] += degrees[j];
-
-    auto unsorted = p.begin(), unsorted_end = p.end();
-
-    while (unsorted != unsorted_end) {
-        // sort on degree
-        std::sort(unsorted, unsorted_end,
-                [&] (int a, int b) { return (! reverse) ^ (
-                    (degrees[a] < degrees[b]) ||
-                    (degrees[a] == degrees[b] && exdegrees[a] < exdegrees[b]) ||
-                    (degrees[a] == degrees[b] && exdegrees[a] == exdegrees[b] && a > b)
-                    ); });
-
-        for (int i = 0 ; i < graph.size() ; ++i)
-            if (graph.adjacent(i, *prev(unsorted_end)))
-                --degrees[i];
-
-        --unsorted_end;
+    // pre-calculate exdegrees
+    auto exdegrees = calculate_exdegrees(graph);
+
+    // repeatedly take the vertex with the smallest (or largest, if reversed)
+    // dynamic degree, tie-breaking on exdegree then vertex number, and put it
+    // at the end of what's left.
+    DegreeBucketQueue<std::pair<long long, int> > queue(graph.size());
+    for (auto & v : p)
+        if (reverse)
+            queue.insert(v, graph.degree(v), std::make_pair(-exdegrees[v], v));
+        else
+            queue.insert(v, graph.degree(v), std::make_pair(exdegrees[v], -v));
+
+    for (auto unsorted_end = p.rbegin() ; unsorted_end != p.rend() ; ++unsorted_end) {
+        int v = reverse ? queue.pop_highest() : queue.pop_lowest();
+        *unsorted_end = v;
+
+        graph.for_each_neighbour(v, [&] (int w) {
+                if (queue.contains(w))
+                    queue.decrement_degree(w);
+                });
     }
 }
 
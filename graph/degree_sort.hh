@@ -27,6 +27,12 @@ namespace parasols
      */
     auto dynexdegree_sort(const Graph & graph, std::vector<int> & p, bool reverse) -> void;
 
+    /**
+     * Calculate the exdegree (the sum of the degrees of its neighbours) of
+     * every vertex. Big graphs are shared out between threads.
+     */
+    auto calculate_exdegrees(const Graph & graph) -> std::vector<long long>;
+
     /**
      * Don't sort the vertices of p.
      */
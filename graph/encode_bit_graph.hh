@@ -0,0 +1,88 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_GRAPH_ENCODE_BIT_GRAPH_HH
+#define PARASOLS_GUARD_GRAPH_ENCODE_BIT_GRAPH_HH 1
+
+#include <graph/graph.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <thread>
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * How many rows a thread grabs at once when encoding. Big enough that
+     * threads rarely share a cache line of the result.
+     */
+    static const constexpr int encode_bit_graph_rows_per_chunk = 256;
+
+    /**
+     * Re-encode graph as a bit graph, with vertex order[i] becoming vertex
+     * i. Vertices not in order are dropped, so order need not be a full
+     * permutation.
+     *
+     * Each row of the result is built from the packed source row in one go,
+     * by walking its set bits, so this is quadratic in words rather than in
+     * vertices. Rows are independent, so for big graphs they are shared out
+     * between up to n_threads threads.
+     *
+     * Returns how long it took, for reporting.
+     */
+    template <typename BitGraph_>
+    auto encode_bit_graph(const Graph & graph, const std::vector<int> & order, unsigned n_threads,
+            BitGraph_ & result) -> std::chrono::milliseconds
+    {
+        using namespace std::chrono;
+
+        auto start_time = steady_clock::now();
+
+        int size = order.size();
+        result.resize(size);
+
+        // where does each original vertex end up, if anywhere?
+        std::vector<int> position(graph.size(), -1);
+        for (int i = 0 ; i < size ; ++i)
+            position[order[i]] = i;
+
+        std::atomic<int> next_chunk{ 0 };
+
+        auto encode_rows = [&] () {
+            while (true) {
+                int first = next_chunk.fetch_add(encode_bit_graph_rows_per_chunk);
+                if (first >= size)
+                    break;
+
+                int last = std::min(size, first + encode_bit_graph_rows_per_chunk);
+                for (int i = first ; i < last ; ++i) {
+                    const Graph::AdjacencyWord * row = graph.row(order[i]);
+                    for (int w = 0 ; w < graph.words_per_row() ; ++w)
+                        for (Graph::AdjacencyWord word = row[w] ; 0 != word ; word &= word - 1) {
+                            int j = position[w * Graph::bits_per_adjacency_word + __builtin_ctzll(word)];
+                            if (-1 != j)
+                                result.add_arc(i, j);
+                        }
+                }
+            }
+        };
+
+        unsigned n_chunks = (size + encode_bit_graph_rows_per_chunk - 1) / encode_bit_graph_rows_per_chunk;
+        unsigned n_workers = std::max(1u, std::min(n_threads, n_chunks));
+
+        std::list<std::thread> threads;
+        for (unsigned t = 1 ; t < n_workers ; ++t)
+            threads.push_back(std::thread(encode_rows));
+
+        encode_rows();
+
+        for (auto & t : threads)
+            t.join();
+
+        return duration_cast<milliseconds>(steady_clock::now() - start_time);
+    }
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <graph/mivia.hh>
 #include <graph/adj.hh>
 #include <graph/lad.hh>
+#include <graph/sparse_graph.hh>
 
 #include <utility>
 #include <functional>
@@ -32,9 +33,18 @@ namespace parasols
             std::make_pair( std::string{ "adj" },     GraphFileFormatFunction{ std::bind(read_adj, _1, _2) } ),
             std::make_pair( std::string{ "lad" },     GraphFileFormatFunction{ std::bind(read_lad, _1, _2) } )
         };
+
+        using SparseGraphFileFormatFunction = std::function<SparseGraph (const std::string &, const GraphOptions &)>;
+
+        auto sparse_graph_file_formats = {
+            std::make_pair( std::string{ "dimacs" },  SparseGraphFileFormatFunction{ std::bind(read_sparse_dimacs, _1, _2) } ),
+            std::make_pair( std::string{ "pairs0" },  SparseGraphFileFormatFunction{ std::bind(read_sparse_pairs, _1, false, _2) } ),
+            std::make_pair( std::string{ "pairs1" },  SparseGraphFileFormatFunction{ std::bind(read_sparse_pairs, _1, true, _2) } )
+        };
     }
 
     using detail::graph_file_formats;
+    using detail::sparse_graph_file_formats;
 }
 
 #endif
@@ -1,7 +1,6 @@
 /* vim: set sw=4 sts=4 et foldmethod=syntax : */
 
 #include <graph/graph.hh>
-#include <algorithm>
 
 using namespace parasols;
 
@@ -14,24 +13,40 @@ Graph::Graph(int size, bool add_one_for_output) :
 
 auto Graph::_position(int a, int b) const -> AdjacencyMatrix::size_type
 {
-    return (a * _size) + b;
+    return AdjacencyMatrix::size_type(a) * _words_per_row + (b / bits_per_adjacency_word);
+}
+
+auto Graph::_mask(int b) const -> AdjacencyWord
+{
+    return AdjacencyWord{ 1 } << (b % bits_per_adjacency_word);
 }
 
 auto Graph::resize(int size) -> void
 {
     _size = size;
-    _adjacency.resize(size * size);
+    _words_per_row = (size + bits_per_adjacency_word - 1) / bits_per_adjacency_word;
+    _adjacency.resize(AdjacencyMatrix::size_type(size) * _words_per_row);
+    _degrees.resize(size);
 }
 
 auto Graph::add_edge(int a, int b) -> void
 {
-    _adjacency[_position(a, b)] = 1;
-    _adjacency[_position(b, a)] = 1;
+    auto & ab = _adjacency[_position(a, b)];
+    if (! (ab & _mask(b))) {
+        ab |= _mask(b);
+        ++_degrees[a];
+    }
+
+    auto & ba = _adjacency[_position(b, a)];
+    if (! (ba & _mask(a))) {
+        ba |= _mask(a);
+        ++_degrees[b];
+    }
 }
 
 auto Graph::adjacent(int a, int b) const -> bool
 {
-    return _adjacency[_position(a, b)];
+    return _adjacency[_position(a, b)] & _mask(b);
 }
 
 auto Graph::size() const -> int
@@ -41,10 +56,17 @@ auto Graph::size() const -> int
 
 auto Graph::degree(int a) const -> int
 {
-    return std::count_if(
-            _adjacency.begin() + a * _size,
-            _adjacency.begin() + (a + 1) * _size,
-            [] (int x) { return !!x; });
+    return _degrees[a];
+}
+
+auto Graph::recalculate_degrees() -> void
+{
+    for (int a = 0 ; a < _size ; ++a) {
+        auto r = row(a);
+        _degrees[a] = 0;
+        for (int w = 0 ; w < _words_per_row ; ++w)
+            _degrees[a] += __builtin_popcountll(r[w]);
+    }
 }
 
 auto Graph::vertex_name(int a) const -> std::string
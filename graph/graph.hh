@@ -14,28 +14,50 @@ namespace parasols
      * A graph, with an adjaceny matrix representation. We only provide the
      * operations we actually need.
      *
+     * The matrix is bit-packed, row-major, with each row padded to a whole
+     * number of 64-bit words. Degrees are maintained as edges are added, so
+     * degree() is constant time.
+     *
      * Indices start at 0.
      */
     class Graph
     {
         public:
+            /**
+             * The type of one word of the adjacency matrix.
+             */
+            using AdjacencyWord = std::uint64_t;
+
             /**
              * The adjaceny matrix type. Shouldn't really be public, but we
              * snoop around inside it when doing message passing.
              */
-            using AdjacencyMatrix = std::vector<std::uint8_t>;
+            using AdjacencyMatrix = std::vector<AdjacencyWord>;
+
+            /**
+             * Number of bits in an AdjacencyWord.
+             */
+            static const constexpr int bits_per_adjacency_word = sizeof(AdjacencyWord) * 8;
 
         private:
             int _size = 0;
+            int _words_per_row = 0;
             AdjacencyMatrix _adjacency;
+            std::vector<int> _degrees;
             bool _add_one_for_output;
 
             /**
-             * Return the appropriate offset into _adjacency for the edge (a,
-             * b).
+             * Return the appropriate word offset into _adjacency for the edge
+             * (a, b).
              */
             auto _position(int a, int b) const -> AdjacencyMatrix::size_type;
 
+            /**
+             * Return the bit within the word given by _position for the edge
+             * (a, b).
+             */
+            auto _mask(int b) const -> AdjacencyWord;
+
         public:
             /**
              * \param initial_size can be 0, if resize() is called afterwards.
@@ -48,6 +70,12 @@ namespace parasols
 
             Graph(const Graph &) = default;
 
+            Graph(Graph &&) = default;
+
+            auto operator= (const Graph &) -> Graph & = default;
+
+            auto operator= (Graph &&) -> Graph & = default;
+
             explicit Graph() = default;
 
             /**
@@ -76,6 +104,38 @@ namespace parasols
              */
             auto degree(int a) const -> int;
 
+            /**
+             * How many words make up each row of the adjacency matrix?
+             */
+            auto words_per_row() const -> int
+            {
+                return _words_per_row;
+            }
+
+            /**
+             * The words making up the adjacency matrix row for a given
+             * vertex, for things that want to work a word at a time. Bits
+             * beyond size() in the last word are always zero.
+             */
+            auto row(int a) const -> const AdjacencyWord *
+            {
+                return &_adjacency[AdjacencyMatrix::size_type(a) * _words_per_row];
+            }
+
+            /**
+             * Call f with each neighbour of a given vertex, in increasing
+             * order. Works a word at a time, so this is much cheaper than
+             * asking adjacent() about every vertex.
+             */
+            template <typename F_>
+            auto for_each_neighbour(int a, F_ && f) const -> void
+            {
+                const AdjacencyWord * r = row(a);
+                for (int w = 0 ; w < _words_per_row ; ++w)
+                    for (AdjacencyWord word = r[w] ; 0 != word ; word &= word - 1)
+                        f(w * bits_per_adjacency_word + __builtin_ctzll(word));
+            }
+
             /**
              * Format a vertex for outputting.
              *
@@ -96,13 +156,20 @@ namespace parasols
 
             /**
              * The adjaceny matrix. Shouldn't really be public, but we snoop
-             * around inside it when doing message passing.
+             * around inside it when doing message passing. If you change it,
+             * call recalculate_degrees() afterwards.
              */
             auto adjaceny_matrix() -> AdjacencyMatrix &
             {
                 return _adjacency;
             }
 
+            /**
+             * Recompute our cached degrees, after someone has been snooping
+             * around inside adjaceny_matrix().
+             */
+            auto recalculate_degrees() -> void;
+
             /**
              * Add one for output?
              */
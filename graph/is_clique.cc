@@ -15,3 +15,14 @@ parasols::is_clique(const Graph & graph, const std::set<int> & members) -> bool
     return true;
 }
 
+auto
+parasols::is_clique(const SparseGraph & graph, const std::set<int> & members) -> bool
+{
+    for (auto & a : members)
+        for (auto & b : members)
+            if (a != b && ! graph.adjacent(a, b))
+                return false;
+
+    return true;
+}
+
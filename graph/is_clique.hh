@@ -4,11 +4,14 @@
 #define PARASOLS_GUARD_GRAPH_IS_CLIQUE_HH 1
 
 #include <graph/graph.hh>
+#include <graph/sparse_graph.hh>
 #include <set>
 
 namespace parasols
 {
     auto is_clique(const Graph & graph, const std::set<int> & members) -> bool;
+
+    auto is_clique(const SparseGraph & graph, const std::set<int> & members) -> bool;
 }
 
 #endif
@@ -1,6 +1,8 @@
 /* vim: set sw=4 sts=4 et foldmethod=syntax : */
 
 #include <graph/min_width_sort.hh>
+#include <graph/degree_sort.hh>
+#include <graph/degree_bucket_queue.hh>
 
 #include <algorithm>
 
@@ -8,76 +10,94 @@ using namespace parasols;
 
 auto parasols::min_width_sort(const Graph & graph, std::vector<int> & p, bool reverse) -> void
 {
-    // pre-calculate degrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
+    // repeatedly remove a vertex of minimum degree, tie-breaking on the
+    // larger vertex number
+    DegreeBucketQueue<int> queue(graph.size());
+    for (auto & v : p)
+        queue.insert(v, graph.degree(v), -v);
 
     std::vector<int> result;
+    result.reserve(p.size());
 
-    while (! p.empty()) {
-        auto min = std::min_element(p.begin(), p.end(),
-                [&] (int a, int b) { return degrees[a] < degrees[b] || (degrees[a] == degrees[b] && a > b); });
+    for (int v ; -1 != (v = queue.pop_lowest()) ; ) {
+        result.push_back(v);
 
-        result.push_back(*min);
-
-        for (auto & v : p)
-            if (graph.adjacent(*min, v))
-                --degrees[v];
-
-        p.erase(min);
+        graph.for_each_neighbour(v, [&] (int w) {
+                if (queue.contains(w))
+                    queue.decrement_degree(w);
+                });
     }
 
     if (reverse)
-        std::swap(result, p);
+        p = result;
     else
-        for (auto r = result.rbegin() ; r != result.rend() ; ++r)
-            p.push_back(*r);
+        p.assign(result.rbegin(), result.rend());
 }
 
 auto parasols::mwsi_sort(const Graph & graph, std::vector<int> & p) -> void
 {
-    // pre-calculate degrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
+    // pre-calculate degrees and supports
+    std::vector<int> degrees((graph.size()));
+    for (int v = 0 ; v < graph.size() ; ++v)
+        degrees[v] = graph.degree(v);
 
     auto unadulterated_degrees = degrees;
+    auto exdegrees = calculate_exdegrees(graph);
 
-    // pre-calculate supports
-    std::vector<int> exdegrees((graph.size()));
-    for (int i = 0 ; i < graph.size() ; ++i)
-        for (int j = 0 ; j < graph.size() ; ++j)
-            if (graph.adjacent(i, j))
-                exdegrees[i] += degrees[j];
-
-    std::vector<int> result;
+    // we walk neighbourhoods a lot, so don't keep scanning rows
+    std::vector<std::vector<int> > neighbours((graph.size()));
+    for (int v = 0 ; v < graph.size() ; ++v) {
+        neighbours[v].reserve(degrees[v]);
+        graph.for_each_neighbour(v, [&] (int w) { neighbours[v].push_back(w); });
+    }
 
-    while (! p.empty()) {
-        auto min = std::min_element(p.begin(), p.end(),
-                [&] (int a, int b) { return
-                (degrees[a] < degrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] < exdegrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] == exdegrees[b] && a < b); });
+    // repeatedly remove a vertex of minimum degree, tie-breaking on support
+    // then the smaller vertex number. Supports are over the remaining
+    // vertices, so removing a vertex changes them out to distance two.
+    DegreeBucketQueue<std::pair<long long, int> > queue(graph.size());
+    for (auto & v : p)
+        queue.insert(v, degrees[v], std::make_pair(exdegrees[v], v));
 
-        result.push_back(*min);
+    std::vector<int> result;
+    result.reserve(p.size());
+
+    std::vector<int> touched;
+    std::vector<bool> is_touched(graph.size(), false);
+    auto touch = [&] (int v) {
+        if (queue.contains(v) && ! is_touched[v]) {
+            is_touched[v] = true;
+            touched.push_back(v);
+        }
+    };
 
-        for (auto & v : p)
-            if (graph.adjacent(*min, v))
-                --degrees[v];
+    for (int v ; -1 != (v = queue.pop_lowest()) ; ) {
+        result.push_back(v);
 
-        p.erase(min);
+        // v no longer contributes to its neighbours' supports...
+        for (auto & w : neighbours[v]) {
+            exdegrees[w] -= degrees[v];
+            touch(w);
+        }
 
-        for (int i = 0 ; i < graph.size() ; ++i) {
-            exdegrees[i] = 0;
-            for (auto & v : p)
-                if (graph.adjacent(i, v))
-                    exdegrees[i] += degrees[v];
+        // ... and its neighbours lose a degree, which their neighbours see
+        for (auto & w : neighbours[v])
+            if (queue.contains(w)) {
+                --degrees[w];
+                touch(w);
+                for (auto & x : neighbours[w]) {
+                    --exdegrees[x];
+                    touch(x);
+                }
+            }
+
+        for (auto & w : touched) {
+            queue.insert(w, degrees[w], std::make_pair(exdegrees[w], w));
+            is_touched[w] = false;
         }
+        touched.clear();
     }
 
-    for (auto r = result.rbegin() ; r != result.rend() ; ++r)
-        p.push_back(*r);
+    p.assign(result.rbegin(), result.rend());
 
     // now the sort step
     std::stable_sort(p.begin(), p.begin() + (p.size() / 4),
@@ -86,43 +106,31 @@ auto parasols::mwsi_sort(const Graph & graph, std::vector<int> & p) -> void
 
 auto parasols::mwssi_sort(const Graph & graph, std::vector<int> & p) -> void
 {
-    // pre-calculate degrees
-    std::vector<int> degrees;
-    std::transform(p.begin(), p.end(), std::back_inserter(degrees),
-            [&] (int v) { return graph.degree(v); });
-
-    auto unadulterated_degrees = degrees;
-
     // pre-calculate supports
-    std::vector<int> exdegrees((graph.size()));
-    for (int i = 0 ; i < graph.size() ; ++i)
-        for (int j = 0 ; j < graph.size() ; ++j)
-            if (graph.adjacent(i, j))
-                exdegrees[i] += degrees[j];
+    auto exdegrees = calculate_exdegrees(graph);
 
-    std::vector<int> result;
-
-    while (! p.empty()) {
-        auto min = std::min_element(p.begin(), p.end(),
-                [&] (int a, int b) { return
-                (degrees[a] < degrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] < exdegrees[b]) ||
-                (degrees[a] == degrees[b] && exdegrees[a] == exdegrees[b] && a < b); });
+    // repeatedly remove a vertex of minimum degree, tie-breaking on static
+    // support then the smaller vertex number
+    DegreeBucketQueue<std::pair<long long, int> > queue(graph.size());
+    for (auto & v : p)
+        queue.insert(v, graph.degree(v), std::make_pair(exdegrees[v], v));
 
-        result.push_back(*min);
+    std::vector<int> result;
+    result.reserve(p.size());
 
-        for (auto & v : p)
-            if (graph.adjacent(*min, v))
-                --degrees[v];
+    for (int v ; -1 != (v = queue.pop_lowest()) ; ) {
+        result.push_back(v);
 
-        p.erase(min);
+        graph.for_each_neighbour(v, [&] (int w) {
+                if (queue.contains(w))
+                    queue.decrement_degree(w);
+                });
     }
 
-    for (auto r = result.rbegin() ; r != result.rend() ; ++r)
-        p.push_back(*r);
+    p.assign(result.rbegin(), result.rend());
 
     // now the sort step
     std::stable_sort(p.begin(), p.begin() + (p.size() / 4),
-                [&] (int a, int b) { return (unadulterated_degrees[a] > unadulterated_degrees[b]); });
+                [&] (int a, int b) { return (graph.degree(a) > graph.degree(b)); });
 }
 
@@ -0,0 +1,351 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <graph/orbits.hh>
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+
+using namespace parasols;
+
+namespace
+{
+    /**
+     * How much work we're prepared to do, in multiples of the size of the
+     * adjacency matrix, subject to a lower limit for small graphs. Looking
+     * at a word of the matrix, or at a vertex, counts as one unit.
+     */
+    const constexpr unsigned long long matrices_of_work = 1;
+    const constexpr unsigned long long minimum_work = 1ull << 22;
+
+    /**
+     * How many refinements we're prepared to try, looking for any one
+     * automorphism.
+     */
+    const constexpr int refinements_per_attempt = 128;
+
+    /**
+     * Partitions whose refinement hasn't settled after this many
+     * individualisations are given up on.
+     */
+    const constexpr unsigned maximum_depth = 64;
+
+    /**
+     * An ordered partition of the vertices. Cells are identified by the
+     * position of their first element.
+     */
+    struct Partition
+    {
+        std::vector<int> elements;
+        std::vector<int> position;
+        std::vector<int> cell_of;
+        std::vector<int> cell_end;
+        int n_cells;
+    };
+
+    struct OutOfWork
+    {
+    };
+
+    struct OrbitFinder
+    {
+        const Graph & graph;
+        int n;
+
+        unsigned long long work_left;
+
+        std::vector<int> parent;
+        std::vector<int> counts;
+        std::vector<bool> in_queue;
+
+        OrbitFinder(const Graph & g) :
+            graph(g),
+            n(g.size()),
+            work_left(std::max(minimum_work,
+                        matrices_of_work * (unsigned long long)(g.size()) * (unsigned long long)(g.words_per_row()))),
+            parent(g.size()),
+            counts(g.size(), 0),
+            in_queue(g.size(), false)
+        {
+            std::iota(parent.begin(), parent.end(), 0);
+        }
+
+        auto spend(unsigned long long w) -> void
+        {
+            if (w >= work_left)
+                throw OutOfWork{ };
+            work_left -= w;
+        }
+
+        auto find(int v) -> int
+        {
+            while (parent[v] != v)
+                v = parent[v] = parent[parent[v]];
+            return v;
+        }
+
+        auto merge(int a, int b) -> void
+        {
+            a = find(a);
+            b = find(b);
+            if (a != b)
+                parent[std::max(a, b)] = std::min(a, b);
+        }
+
+        auto unit_partition() -> Partition
+        {
+            Partition result;
+            result.elements.resize(n);
+            std::iota(result.elements.begin(), result.elements.end(), 0);
+            result.position = result.elements;
+            result.cell_of.assign(n, 0);
+            result.cell_end.assign(n, 0);
+            result.cell_end[0] = n;
+            result.n_cells = 1;
+            return result;
+        }
+
+        /**
+         * Refine until equitable, starting with the given splitters. A cell
+         * is only split by how many neighbours its members have in a
+         * splitter, and the pieces are ordered by that, so this commutes
+         * with relabelling the graph.
+         */
+        auto refine(Partition & p, std::deque<int> queue) -> void
+        {
+            for (auto & s : queue)
+                in_queue[s] = true;
+
+            std::vector<int> touched, touched_cells;
+
+            while (! queue.empty()) {
+                int s = queue.front();
+                queue.pop_front();
+                in_queue[s] = false;
+
+                // count neighbours in the splitter
+                spend((p.cell_end[s] - s) * (unsigned long long)(graph.words_per_row()));
+                for (int i = s ; i < p.cell_end[s] ; ++i) {
+                    const Graph::AdjacencyWord * row = graph.row(p.elements[i]);
+                    for (int w = 0 ; w < graph.words_per_row() ; ++w)
+                        for (Graph::AdjacencyWord word = row[w] ; 0 != word ; word &= word - 1) {
+                            int u = w * Graph::bits_per_adjacency_word + __builtin_ctzll(word);
+                            if (0 == counts[u]++)
+                                touched.push_back(u);
+                        }
+                }
+
+                spend(touched.size());
+                for (auto & u : touched)
+                    if (p.cell_end[p.cell_of[u]] - p.cell_of[u] > 1)
+                        touched_cells.push_back(p.cell_of[u]);
+                std::sort(touched_cells.begin(), touched_cells.end());
+                touched_cells.erase(std::unique(touched_cells.begin(), touched_cells.end()), touched_cells.end());
+
+                // split every cell with members having different counts
+                for (auto & c : touched_cells) {
+                    int end = p.cell_end[c];
+                    spend(end - c);
+                    std::stable_sort(p.elements.begin() + c, p.elements.begin() + end,
+                            [&] (int a, int b) { return counts[a] < counts[b]; });
+                    if (counts[p.elements[c]] == counts[p.elements[end - 1]])
+                        continue;
+
+                    std::vector<int> pieces;
+                    for (int i = c ; i < end ; ++i) {
+                        if (i == c || counts[p.elements[i]] != counts[p.elements[i - 1]])
+                            pieces.push_back(i);
+                        p.position[p.elements[i]] = i;
+                        p.cell_of[p.elements[i]] = pieces.back();
+                    }
+                    pieces.push_back(end);
+
+                    int largest = 0;
+                    for (unsigned i = 0 ; i + 1 < pieces.size() ; ++i) {
+                        p.cell_end[pieces[i]] = pieces[i + 1];
+                        if (pieces[i + 1] - pieces[i] > pieces[largest + 1] - pieces[largest])
+                            largest = i;
+                    }
+                    p.n_cells += pieces.size() - 2;
+
+                    // if c was already waiting, all of it still has to be
+                    // used, otherwise we can leave out the biggest piece
+                    bool all = in_queue[c];
+                    for (unsigned i = 0 ; i + 1 < pieces.size() ; ++i)
+                        if ((all || int(i) != largest) && ! in_queue[pieces[i]]) {
+                            in_queue[pieces[i]] = true;
+                            queue.push_back(pieces[i]);
+                        }
+                }
+
+                for (auto & u : touched)
+                    counts[u] = 0;
+                touched.clear();
+                touched_cells.clear();
+            }
+        }
+
+        /**
+         * Give v a cell of its own, at the front of its old one, and refine.
+         */
+        auto individualise(Partition & p, int v) -> void
+        {
+            spend(n);
+
+            int c = p.cell_of[v], end = p.cell_end[c];
+            if (end - c == 1)
+                return;
+
+            int other = p.elements[c];
+            std::swap(p.elements[c], p.elements[p.position[v]]);
+            std::swap(p.position[v], p.position[other]);
+
+            p.cell_end[c] = c + 1;
+            p.cell_end[c + 1] = end;
+            for (int i = c + 1 ; i < end ; ++i)
+                p.cell_of[p.elements[i]] = c + 1;
+            ++p.n_cells;
+
+            refine(p, std::deque<int>{ c });
+        }
+
+        auto copy(const Partition & p) -> Partition
+        {
+            spend(n);
+            return p;
+        }
+
+        auto first_non_trivial_cell(const Partition & p) -> int
+        {
+            spend(p.n_cells);
+            for (int c = 0 ; c < n ; c = p.cell_end[c])
+                if (p.cell_end[c] - c > 1)
+                    return c;
+            return -1;
+        }
+
+        auto same_shape(const Partition & a, const Partition & b) -> bool
+        {
+            spend(a.n_cells);
+            if (a.n_cells != b.n_cells)
+                return false;
+            for (int c = 0 ; c < n ; c = a.cell_end[c])
+                if (a.cell_end[c] != b.cell_end[c] || b.cell_of[b.elements[c]] != c)
+                    return false;
+            return true;
+        }
+
+        /**
+         * Two discrete partitions give a bijection. If it's an automorphism,
+         * merge everything it moves.
+         */
+        auto try_leaf(const Partition & a, const Partition & b) -> bool
+        {
+            spend(n * (unsigned long long)(graph.words_per_row()));
+
+            std::vector<int> sigma(n);
+            for (int i = 0 ; i < n ; ++i)
+                sigma[a.elements[i]] = b.elements[i];
+
+            // a bijection mapping every edge to an edge is an automorphism
+            for (int u = 0 ; u < n ; ++u) {
+                const Graph::AdjacencyWord * row = graph.row(u);
+                for (int w = 0 ; w < graph.words_per_row() ; ++w)
+                    for (Graph::AdjacencyWord word = row[w] ; 0 != word ; word &= word - 1) {
+                        int x = w * Graph::bits_per_adjacency_word + __builtin_ctzll(word);
+                        if (x > u && ! graph.adjacent(sigma[u], sigma[x]))
+                            return false;
+                    }
+            }
+
+            for (int u = 0 ; u < n ; ++u)
+                merge(u, sigma[u]);
+
+            return true;
+        }
+
+        /**
+         * Extend q, which has the same shape as path[depth], to a leaf which
+         * gives an automorphism.
+         */
+        auto search(const std::vector<Partition> & path, const std::vector<int> & targets,
+                unsigned depth, const Partition & q, int & refinements) -> bool
+        {
+            if (depth + 1 == path.size())
+                return try_leaf(path.back(), q);
+
+            int t = targets[depth];
+            for (int i = t ; i < q.cell_end[t] ; ++i) {
+                if (++refinements > refinements_per_attempt)
+                    return false;
+
+                Partition child = copy(q);
+                individualise(child, q.elements[i]);
+                if (same_shape(path[depth + 1], child) && search(path, targets, depth + 1, child, refinements))
+                    return true;
+            }
+
+            return false;
+        }
+
+        auto run() -> void
+        {
+            if (0 == n)
+                return;
+
+            Partition root = unit_partition();
+            refine(root, std::deque<int>{ 0 });
+
+            for (int c = 0 ; c < n ; c = root.cell_end[c]) {
+                if (root.cell_end[c] - c == 1)
+                    continue;
+
+                // the path we're trying to match, starting with the first
+                // vertex in this cell
+                int r = root.elements[c];
+                std::vector<Partition> path{ root };
+                std::vector<int> targets{ c };
+                path.push_back(copy(root));
+                individualise(path.back(), r);
+                while (-1 != first_non_trivial_cell(path.back()) && path.size() <= maximum_depth) {
+                    targets.push_back(first_non_trivial_cell(path.back()));
+                    path.push_back(copy(path.back()));
+                    individualise(path.back(), path.back().elements[targets.back()]);
+                }
+
+                if (-1 != first_non_trivial_cell(path.back()))
+                    continue;
+
+                for (int i = c + 1 ; i < root.cell_end[c] ; ++i) {
+                    int w = root.elements[i];
+                    if (find(w) == find(r))
+                        continue;
+
+                    int refinements = 1;
+                    Partition q = copy(root);
+                    individualise(q, w);
+                    if (same_shape(path[1], q))
+                        search(path, targets, 1, q, refinements);
+                }
+            }
+        }
+    };
+}
+
+auto parasols::find_orbits(const Graph & graph) -> std::vector<int>
+{
+    OrbitFinder finder(graph);
+
+    try {
+        finder.run();
+    }
+    catch (const OutOfWork &) {
+        // everything merged so far came from a real automorphism
+    }
+
+    std::vector<int> result(graph.size());
+    for (int v = 0 ; v < graph.size() ; ++v)
+        result[v] = finder.find(v);
+    return result;
+}
+
@@ -0,0 +1,34 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_GRAPH_ORBITS_HH
+#define PARASOLS_GUARD_GRAPH_ORBITS_HH 1
+
+#include <graph/graph.hh>
+
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * Find orbits of the automorphism group of a graph, by individualisation
+     * and refinement.
+     *
+     * We refine to an equitable partition, and then for each vertex r which
+     * shares a cell with something, we individualise r (and then the first
+     * vertex of the first non-trivial cell, and so on) until the partition
+     * is discrete. For every other w in r's cell, we look for a matching
+     * path starting from w instead, backtracking as necessary, and if its
+     * leaf gives an automorphism, everything it moves is merged into one
+     * orbit.
+     *
+     * The amount of work done is limited to a small multiple of the size of
+     * the adjacency matrix. If we run out, we may return orbits which are
+     * smaller than the real ones, but two vertices are only ever put in the
+     * same orbit if an automorphism maps one to the other.
+     *
+     * Returns, for each vertex, the smallest vertex in its orbit.
+     */
+    auto find_orbits(const Graph & graph) -> std::vector<int>;
+}
+
+#endif
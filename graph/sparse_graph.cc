@@ -0,0 +1,180 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <graph/sparse_graph.hh>
+#include <graph/graph_file_error.hh>
+
+#include <boost/regex.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+
+using namespace parasols;
+
+namespace
+{
+    /**
+     * Parse two non-negative integers, separated by whitespace or a comma,
+     * from the whole of s. These files can have tens of millions of lines,
+     * so we don't want to go through a regex for every edge.
+     */
+    auto parse_two_ints(const char * s, long & a, long & b) -> bool
+    {
+        char * end;
+
+        while (std::isspace(*s))
+            ++s;
+        if (! std::isdigit(*s))
+            return false;
+        a = std::strtol(s, &end, 10);
+        s = end;
+
+        if (! (std::isspace(*s) || ',' == *s))
+            return false;
+        if (',' == *s)
+            ++s;
+        while (std::isspace(*s))
+            ++s;
+        if (! std::isdigit(*s))
+            return false;
+        b = std::strtol(s, &end, 10);
+        s = end;
+
+        while (std::isspace(*s))
+            ++s;
+        return '\0' == *s;
+    }
+}
+
+SparseGraph::SparseGraph(int size, std::vector<std::pair<int, int> > & edges, bool add_one_for_output) :
+    _size(size),
+    _offsets(size + 1, 0),
+    _add_one_for_output(add_one_for_output)
+{
+    // make every edge go both ways, and then sort, so each vertex's
+    // neighbours end up together
+    auto n_edges = edges.size();
+    edges.reserve(2 * n_edges);
+    for (decltype(n_edges) e = 0 ; e < n_edges ; ++e)
+        edges.emplace_back(edges[e].second, edges[e].first);
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    _neighbours.reserve(edges.size());
+    for (auto & e : edges) {
+        ++_offsets[e.first + 1];
+        _neighbours.push_back(e.second);
+    }
+
+    for (int v = 0 ; v < size ; ++v)
+        _offsets[v + 1] += _offsets[v];
+}
+
+auto SparseGraph::adjacent(int a, int b) const -> bool
+{
+    auto n = neighbours(a);
+    return std::binary_search(n.first, n.second, b);
+}
+
+auto SparseGraph::vertex_name(int a) const -> std::string
+{
+    if (_add_one_for_output)
+        return std::to_string(a + 1);
+    else
+        return std::to_string(a);
+}
+
+auto parasols::read_sparse_dimacs(const std::string & filename, const GraphOptions & options) -> SparseGraph
+{
+    int size = -1;
+    std::vector<std::pair<int, int> > edges;
+
+    std::ifstream infile{ filename };
+    if (! infile)
+        throw GraphFileError{ filename, "unable to open file" };
+
+    std::string line;
+    while (std::getline(infile, line)) {
+        if (line.empty())
+            continue;
+
+        /* Lines are comments, a problem description (contains the number of
+         * vertices), or an edge. */
+        static const boost::regex
+            comment{ R"(c(\s.*)?)" },
+            problem{ R"(p\s+(edge|col)\s+(\d+)\s+(\d+)?\s*)" };
+
+        long a, b;
+        boost::smatch match;
+        if ('e' == line[0] && parse_two_ints(line.c_str() + 1, a, b)) {
+            /* An edge. DIMACS files are 1-indexed. We assume we've already had
+             * a problem line. */
+            if (0 == a || 0 == b || a > size || b > size)
+                throw GraphFileError{ filename, "line '" + line + "' edge index out of bounds" };
+            else if (a == b && ! test(options, GraphOptions::AllowLoops))
+                throw GraphFileError{ filename, "line '" + line + "' contains a loop on vertex " + std::to_string(a) };
+            edges.emplace_back(a - 1, b - 1);
+        }
+        else if (regex_match(line, match, comment)) {
+            /* Comment, ignore */
+        }
+        else if (regex_match(line, match, problem)) {
+            /* Problem. Specifies the size of the graph. Must happen exactly
+             * once. */
+            if (-1 != size)
+                throw GraphFileError{ filename, "multiple 'p' lines encountered" };
+            size = std::stoi(match.str(2));
+            if (match[3].matched)
+                edges.reserve(std::stol(match.str(3)));
+        }
+        else
+            throw GraphFileError{ filename, "cannot parse line '" + line + "'" };
+    }
+
+    if (! infile.eof())
+        throw GraphFileError{ filename, "error reading file" };
+
+    return SparseGraph{ std::max(size, 0), edges, true };
+}
+
+auto parasols::read_sparse_pairs(const std::string & filename, bool one_indexed, const GraphOptions & options) -> SparseGraph
+{
+    long size = 0;
+    std::vector<std::pair<int, int> > edges;
+
+    std::ifstream infile{ filename };
+    if (! infile)
+        throw GraphFileError{ filename, "unable to open file" };
+
+    std::string line;
+    while (std::getline(infile, line)) {
+        if (line.empty() || '#' == line[0] || '%' == line[0])
+            continue;
+
+        long a, b;
+        if (! parse_two_ints(line.c_str(), a, b))
+            throw GraphFileError{ filename, "cannot parse line '" + line + "'" };
+
+        if (one_indexed) {
+            --a;
+            --b;
+        }
+
+        if (a < 0 || b < 0 || a >= std::numeric_limits<int>::max() || b >= std::numeric_limits<int>::max())
+            throw GraphFileError{ filename, "line '" + line + "' edge index out of bounds" };
+        else if (a == b && ! test(options, GraphOptions::AllowLoops))
+            throw GraphFileError{ filename, "line '" + line + "' contains a loop on vertex " + std::to_string(a) };
+
+        edges.emplace_back(a, b);
+        size = std::max(size, std::max(a, b) + 1);
+    }
+
+    if (! infile.eof())
+        throw GraphFileError{ filename, "error reading file" };
+
+    return SparseGraph{ int(size), edges, one_indexed };
+}
+
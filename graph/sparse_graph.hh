@@ -0,0 +1,118 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_GRAPH_SPARSE_GRAPH_HH
+#define PARASOLS_GUARD_GRAPH_SPARSE_GRAPH_HH 1
+
+#include <graph/graph.hh>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * A graph, with an adjacency list representation, for graphs far too
+     * big for Graph's adjacency matrix. Neighbours are stored one after
+     * another, sorted, in one big array, and the graph can't be changed
+     * once it's been built.
+     *
+     * Indices start at 0.
+     */
+    class SparseGraph
+    {
+        private:
+            int _size = 0;
+            std::vector<std::size_t> _offsets;
+            std::vector<int> _neighbours;
+            bool _add_one_for_output;
+
+        public:
+            /**
+             * Build a graph with the given edges. Each edge need only be
+             * listed in one direction, and duplicates are ignored. The edges
+             * are sorted in place.
+             *
+             * \param add_one_for_output is as for Graph.
+             */
+            SparseGraph(int size, std::vector<std::pair<int, int> > & edges, bool add_one_for_output);
+
+            SparseGraph(const SparseGraph &) = default;
+
+            SparseGraph(SparseGraph &&) = default;
+
+            /**
+             * Number of vertices.
+             */
+            auto size() const -> int
+            {
+                return _size;
+            }
+
+            /**
+             * What is the degree of a given vertex?
+             */
+            auto degree(int a) const -> int
+            {
+                return _offsets[a + 1] - _offsets[a];
+            }
+
+            /**
+             * The neighbours of a given vertex, in increasing order, as a
+             * [begin, end) pair of pointers.
+             */
+            auto neighbours(int a) const -> std::pair<const int *, const int *>
+            {
+                return std::make_pair(_neighbours.data() + _offsets[a], _neighbours.data() + _offsets[a + 1]);
+            }
+
+            /**
+             * Call f with each neighbour of a given vertex, in increasing
+             * order.
+             */
+            template <typename F_>
+            auto for_each_neighbour(int a, F_ && f) const -> void
+            {
+                for (auto n = neighbours(a) ; n.first != n.second ; ++n.first)
+                    f(*n.first);
+            }
+
+            /**
+             * Are vertices a and b adjacent? Logarithmic in the degree of a.
+             */
+            auto adjacent(int a, int b) const -> bool;
+
+            /**
+             * Format a vertex for outputting, as for Graph.
+             */
+            auto vertex_name(int a) const -> std::string;
+
+            /**
+             * Add one for output?
+             */
+            auto add_one_for_output() const -> bool
+            {
+                return _add_one_for_output;
+            }
+    };
+
+    /**
+     * Read a DIMACS format file into a SparseGraph.
+     *
+     * \throw GraphFileError
+     */
+    auto read_sparse_dimacs(const std::string & filename, const GraphOptions & options) -> SparseGraph;
+
+    /**
+     * Read a file with one edge per line into a SparseGraph. Unlike
+     * read_pairs, there is no header: the number of vertices is one more
+     * than the largest vertex mentioned. Lines starting with a '#' or a '%'
+     * are comments, as is usual for big network datasets.
+     *
+     * \throw GraphFileError
+     */
+    auto read_sparse_pairs(const std::string & filename, bool one_indexed, const GraphOptions & options) -> SparseGraph;
+}
+
+#endif
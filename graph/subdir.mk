@@ -2,7 +2,10 @@ TARGET := libgraph.a
 
 SOURCES := \
 	bit_graph.cc \
+	bit_kernels.cc \
+	encode_bit_graph.cc \
 	degree_sort.cc \
+	degree_bucket_queue.cc \
 	min_width_sort.cc \
 	graph_file_error.cc \
 	adj.cc \
@@ -24,5 +27,7 @@ SOURCES := \
 	product.cc \
 	kneighbours.cc \
 	add_dominated_vertices.cc \
+	sparse_graph.cc \
+	orbits.cc \
 	merge_cliques.cc
 
@@ -41,10 +41,16 @@ namespace parasols
                 std::false_type>::type>::type;
     };
 
+    template <>
+    struct IndexSizes<dynamic_words>
+    {
+        using Type = unsigned;
+    };
+
     template <template <unsigned, typename> class Algorithm_, typename Result_, typename Graph_, unsigned... sizes_, typename... Params_>
     auto select_graph_size(const GraphSizes<sizes_...> &, const Graph_ & graph, Params_ && ... params) -> Result_
     {
-        if (graph.size() < GraphSizes<sizes_...>::n * bits_per_word) {
+        if (dynamic_words == GraphSizes<sizes_...>::n || graph.size() < GraphSizes<sizes_...>::n * bits_per_word) {
             Algorithm_<GraphSizes<sizes_...>::n, typename IndexSizes<GraphSizes<sizes_...>::n>::Type> algorithm{
                 graph, std::forward<Params_>(params)... };
             return algorithm.run();
@@ -64,6 +70,11 @@ namespace parasols
     static_assert(max_graph_words == 1024, "Need to update here if max_graph_size is changed.");
 
     using AllGraphSizes = GraphSizes<1, 2, 3, 4, 5, 6, 7, 8, 16, 20, 24, 28, 32, 64, 128, 256, 512, 1024>;
+
+    /* As above, but with no upper limit: anything too big for a fixed size
+     * gets a DynamicBitGraph. Only for algorithms written in terms of
+     * BitSet, BitGraph and VertexArray. */
+    using AllGraphSizesAndDynamic = GraphSizes<1, 2, 3, 4, 5, 6, 7, 8, 16, 20, 24, 28, 32, 64, 128, 256, 512, 1024, dynamic_words>;
 }
 
 #endif
@@ -3,9 +3,11 @@ SUBMAKEFILES := \
 	cco/subdir.mk \
 	max_biclique/subdir.mk \
 	max_clique/subdir.mk \
+	max_clique_mpi/subdir.mk \
 	max_common_subgraph/subdir.mk \
 	max_labelled_clique/subdir.mk \
 	programs/about_graph/subdir.mk \
+	programs/bitset_benchmark/subdir.mk \
 	programs/combine_graphs/subdir.mk \
 	programs/create_random_bipartite_graph/subdir.mk \
 	programs/create_random_graph/subdir.mk \
@@ -18,8 +20,11 @@ SUBMAKEFILES := \
 	programs/modify_graph/subdir.mk \
 	programs/solve_max_biclique/subdir.mk \
 	programs/solve_max_clique/subdir.mk \
+	programs/solve_max_clique_mpi/subdir.mk \
 	programs/solve_max_common_subgraph/subdir.mk \
 	programs/solve_max_labelled_clique/subdir.mk \
+	programs/solve_maximal_cliques/subdir.mk \
+	programs/solve_sparse_max_clique/subdir.mk \
 	programs/solve_subgraph_isomorphism/subdir.mk \
 	programs/solve_vertex_colouring/subdir.mk \
 	programs/subgraph_isomorphism_association_density_graph/subdir.mk \
@@ -34,7 +39,9 @@ TARGET_DIR := $(shell echo build/`hostname`)
 
 boost_ldlibs := -lboost_regex -lboost_thread -lboost_system -lboost_program_options
 
-boost_mpi_ldlibs := -lboost_mpi -lboost_serialization
+boost_mpi_ldlibs := -lboost_mpi -lboost_serialization $(shell mpicxx --showme:link)
+
+mpi_cxxflags := $(shell mpicxx --showme:compile)
 
 override CXXFLAGS += -O3 -march=native -std=c++14 -I./ -W -Wall -pthread -g
 override LDFLAGS += -pthread
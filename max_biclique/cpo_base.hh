@@ -4,6 +4,7 @@
 #define PARASOLS_GUARD_MAX_BICLIQUE_CPO_BASE_HH 1
 
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
 #include <cco/cco_mixin.hh>
 #include <max_biclique/max_biclique_params.hh>
 #include <max_biclique/max_biclique_result.hh>
@@ -19,9 +20,10 @@ namespace parasols
         using CCOMixin<size_, VertexType_, CPOBase<perm_, sym_, size_, VertexType_, ActualType_>, true>::colour_class_order;
 
         const Graph & original_graph;
-        FixedBitGraph<size_> graph;
+        BitGraph<size_> graph;
         const MaxBicliqueParams & params;
         std::vector<int> order;
+        std::chrono::milliseconds encode_time;
 
         CPOBase(const Graph & g, const MaxBicliqueParams & p) :
             original_graph(g),
@@ -33,23 +35,18 @@ namespace parasols
             params.order_function(g, order);
 
             // re-encode graph as a bit graph
-            graph.resize(g.size());
-
-            for (int i = 0 ; i < g.size() ; ++i)
-                for (int j = 0 ; j < g.size() ; ++j)
-                    if (g.adjacent(order[i], order[j]))
-                        graph.add_edge(i, j);
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
         }
 
         template <typename... MoreArgs_>
         auto expand(
                 std::vector<unsigned> & ca,
                 std::vector<unsigned> & cb,
-                FixedBitSet<size_> & pa,
-                FixedBitSet<size_> & pb,
-                FixedBitSet<size_> & sym_skip,
-                const std::array<VertexType_, size_ * bits_per_word> & pa_order,
-                const std::array<VertexType_, size_ * bits_per_word> & pa_bound,
+                BitSet<size_> & pa,
+                BitSet<size_> & pb,
+                BitSet<size_> & sym_skip,
+                const VertexArray<size_, VertexType_> & pa_order,
+                const VertexArray<size_, VertexType_> & pa_bound,
                 std::vector<int> & position,
                 MoreArgs_ && ... more_args_
                 ) -> void
@@ -90,7 +87,7 @@ namespace parasols
 
                     // filter pb to contain vertices adjacent to v, and pa to contain
                     // vertices not adjacent to v
-                    FixedBitSet<size_> new_pa = pa, new_pb = pb;
+                    BitSet<size_> new_pa = pa, new_pb = pb;
                     graph.intersect_with_row_complement(v, new_pa);
                     graph.intersect_with_row(v, new_pb);
 
@@ -98,8 +95,10 @@ namespace parasols
 
                     if (! new_pb.empty()) {
                         position.push_back(0);
-                        std::array<VertexType_, size_ * bits_per_word> new_pb_order;
-                        std::array<VertexType_, size_ * bits_per_word> new_pb_bound;
+                        VertexArray<size_, VertexType_> new_pb_order;
+                        VertexArray<size_, VertexType_> new_pb_bound;
+                        resize_vertex_array(new_pb_order, graph.size());
+                        resize_vertex_array(new_pb_bound, graph.size());
                         colour_class_order(SelectColourClassOrderOverload<perm_>(), new_pb, new_pb_order, new_pb_bound);
                         keep_going = static_cast<ActualType_ *>(this)->recurse(
                                 cb, ca, new_pb, new_pa, sym_skip, new_pb_order, new_pb_bound, position, std::forward<MoreArgs_>(more_args_)...) && keep_going;
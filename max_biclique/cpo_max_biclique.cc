@@ -25,6 +25,7 @@ namespace
         using Base::params;
         using Base::expand;
         using Base::order;
+        using Base::encode_time;
         using Base::colour_class_order;
 
         MaxBicliqueResult result;
@@ -34,24 +35,30 @@ namespace
         auto run() -> MaxBicliqueResult
         {
             result.size = params.initial_bound;
+            result.times.push_back(encode_time);
 
             std::vector<unsigned> ca, cb;
             ca.reserve(graph.size());
             cb.reserve(graph.size());
 
-            FixedBitSet<size_> pa, pb; // potential additions
+            BitSet<size_> pa, pb; // potential additions
+            pa.resize(graph.size());
+            pb.resize(graph.size());
             pa.set_up_to(graph.size());
             pb.set_up_to(graph.size());
 
-            FixedBitSet<size_> sym_skip;
+            BitSet<size_> sym_skip;
+            sym_skip.resize(graph.size());
 
             std::vector<int> positions;
             positions.reserve(graph.size());
             positions.push_back(0);
 
             // initial colouring
-            std::array<VertexType_, size_ * bits_per_word> initial_p_order;
-            std::array<VertexType_, size_ * bits_per_word> initial_bound;
+            VertexArray<size_, VertexType_> initial_p_order;
+            VertexArray<size_, VertexType_> initial_bound;
+            resize_vertex_array(initial_p_order, graph.size());
+            resize_vertex_array(initial_bound, graph.size());
             colour_class_order(SelectColourClassOrderOverload<perm_>(), pa, initial_p_order, initial_bound);
 
             // go!
@@ -68,11 +75,11 @@ namespace
         auto recurse(
                 std::vector<unsigned> & ca,
                 std::vector<unsigned> & cb,
-                FixedBitSet<size_> & pa,
-                FixedBitSet<size_> & pb,
-                FixedBitSet<size_> & sym_skip,
-                const std::array<VertexType_, size_ * bits_per_word> & pa_order,
-                const std::array<VertexType_, size_ * bits_per_word> & pa_bounds,
+                BitSet<size_> & pa,
+                BitSet<size_> & pb,
+                BitSet<size_> & sym_skip,
+                const VertexArray<size_, VertexType_> & pa_order,
+                const VertexArray<size_, VertexType_> & pa_bounds,
                 std::vector<int> & position
                 ) -> bool
         {
@@ -115,7 +122,7 @@ namespace
 template <CCOPermutations perm_, BicliqueSymmetryRemoval sym_>
 auto parasols::cpo_max_biclique(const Graph & graph, const MaxBicliqueParams & params) -> MaxBicliqueResult
 {
-    return select_graph_size<ApplyPermSym<CPO, perm_, sym_>::template Type, MaxBicliqueResult>(AllGraphSizes(), graph, params);
+    return select_graph_size<ApplyPermSym<CPO, perm_, sym_>::template Type, MaxBicliqueResult>(AllGraphSizesAndDynamic(), graph, params);
 }
 
 template auto parasols::cpo_max_biclique<CCOPermutations::None, BicliqueSymmetryRemoval::None>(const Graph &, const MaxBicliqueParams &) -> MaxBicliqueResult;
@@ -22,7 +22,8 @@ namespace parasols
 
         /**
          * Runtimes. The first entry in the list is the total runtime.
-         * Additional values are for each worker thread.
+         * Algorithms which re-encode the graph as a bit graph then say how
+         * long that took. Additional values are for each worker thread.
          */
         std::list<std::chrono::milliseconds> times;
 
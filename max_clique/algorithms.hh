@@ -7,6 +7,8 @@
 #include <max_clique/cco_max_clique.hh>
 #include <max_clique/tcco_max_clique.hh>
 #include <max_clique/ost_max_clique.hh>
+#include <max_clique/tost_max_clique.hh>
+#include <max_clique/dcco_max_clique.hh>
 
 #include <utility>
 #include <string>
@@ -18,16 +20,24 @@ namespace parasols
 
         std::make_pair( std::string{ "ccon" },      cco_max_clique<CCOPermutations::None, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "ccod" },      cco_max_clique<CCOPermutations::Defer1, CCOInference::None, CCOMerge::None>),
+        std::make_pair( std::string{ "ccoi" },      cco_max_clique<CCOPermutations::Inherit, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "cconra" },    cco_max_clique<CCOPermutations::RepairAll, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "ccodra" },    cco_max_clique<CCOPermutations::RepairAllDefer1, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "cconrs" },    cco_max_clique<CCOPermutations::RepairSelected, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "ccodrs" },    cco_max_clique<CCOPermutations::RepairSelectedDefer1, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "cconrsf" },   cco_max_clique<CCOPermutations::RepairSelectedFast, CCOInference::None, CCOMerge::None>),
         std::make_pair( std::string{ "cconraf" },   cco_max_clique<CCOPermutations::RepairAllFast, CCOInference::None, CCOMerge::None>),
+        std::make_pair( std::string{ "cconrab" },   cco_max_clique<CCOPermutations::RepairAllBitSet, CCOInference::None, CCOMerge::None>),
+        std::make_pair( std::string{ "ccodrab" },   cco_max_clique<CCOPermutations::RepairAllDefer1BitSet, CCOInference::None, CCOMerge::None>),
+        std::make_pair( std::string{ "cconrsb" },   cco_max_clique<CCOPermutations::RepairSelectedBitSet, CCOInference::None, CCOMerge::None>),
+        std::make_pair( std::string{ "ccodrsb" },   cco_max_clique<CCOPermutations::RepairSelectedDefer1BitSet, CCOInference::None, CCOMerge::None>),
 
         std::make_pair( std::string{ "cconlgd" },   cco_max_clique<CCOPermutations::None, CCOInference::LazyGlobalDomination, CCOMerge::None>),
         std::make_pair( std::string{ "ccodlgd" },   cco_max_clique<CCOPermutations::Defer1, CCOInference::LazyGlobalDomination, CCOMerge::None>),
 
+        std::make_pair( std::string{ "cconic" },    cco_max_clique<CCOPermutations::None, CCOInference::InfraChromatic, CCOMerge::None>),
+        std::make_pair( std::string{ "ccodic" },    cco_max_clique<CCOPermutations::Defer1, CCOInference::InfraChromatic, CCOMerge::None>),
+
         std::make_pair( std::string{ "cconmp" },    cco_max_clique<CCOPermutations::None, CCOInference::None, CCOMerge::Previous>),
         std::make_pair( std::string{ "ccodmp" },    cco_max_clique<CCOPermutations::Defer1, CCOInference::None, CCOMerge::Previous>),
 
@@ -36,11 +46,35 @@ namespace parasols
 
         std::make_pair( std::string{ "tccon" },     tcco_max_clique<CCOPermutations::None, CCOInference::None, false>),
         std::make_pair( std::string{ "tccod" },     tcco_max_clique<CCOPermutations::Defer1, CCOInference::None, false>),
+        std::make_pair( std::string{ "tccoi" },     tcco_max_clique<CCOPermutations::Inherit, CCOInference::None, false>),
+
+        std::make_pair( std::string{ "tcconlgd" },  tcco_max_clique<CCOPermutations::None, CCOInference::LazyGlobalDomination, false>),
+        std::make_pair( std::string{ "tccodlgd" },  tcco_max_clique<CCOPermutations::Defer1, CCOInference::LazyGlobalDomination, false>),
+
+        std::make_pair( std::string{ "tcconic" },   tcco_max_clique<CCOPermutations::None, CCOInference::InfraChromatic, false>),
+        std::make_pair( std::string{ "tccodic" },   tcco_max_clique<CCOPermutations::Defer1, CCOInference::InfraChromatic, false>),
 
         std::make_pair( std::string{ "tcconmq" },   tcco_max_clique<CCOPermutations::None, CCOInference::None, true>),
         std::make_pair( std::string{ "tccodmq" },   tcco_max_clique<CCOPermutations::Defer1, CCOInference::None, true>),
 
-        std::make_pair( std::string{ "ost" },       ost_max_clique)
+        std::make_pair( std::string{ "ost" },       ost_max_clique),
+        std::make_pair( std::string{ "tost" },      tost_max_clique)
+    };
+
+    /**
+     * Versions of some of the above which solve independent set on the graph
+     * as given, without having to take its complement.
+     */
+    auto max_independent_set_algorithms = {
+        std::make_pair( std::string{ "ccon" },      cco_max_independent_set<CCOPermutations::None>),
+        std::make_pair( std::string{ "ccod" },      cco_max_independent_set<CCOPermutations::Defer1>),
+        std::make_pair( std::string{ "tccon" },     tcco_max_independent_set<CCOPermutations::None>),
+        std::make_pair( std::string{ "tccod" },     tcco_max_independent_set<CCOPermutations::Defer1>)
+    };
+
+    auto sparse_max_clique_algorithms = {
+        std::make_pair( std::string{ "dccon" },     dcco_max_clique<CCOPermutations::None>),
+        std::make_pair( std::string{ "dccod" },     dcco_max_clique<CCOPermutations::Defer1>)
     };
 }
 
@@ -0,0 +1,216 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/bk_maximal_cliques.hh>
+#include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
+#include <graph/template_voodoo.hh>
+#include <graph/degree_bucket_queue.hh>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using namespace parasols;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+    template <unsigned size_, typename VertexType_>
+    struct BK
+    {
+        FixedBitGraph<size_> graph;
+        const MaxCliqueParams & params;
+        std::vector<int> order;
+        std::chrono::milliseconds encode_time;
+
+        BK(const Graph & g, const MaxCliqueParams & p) :
+            params(p)
+        {
+            // degeneracy order: repeatedly remove a vertex of minimum degree
+            order.reserve(g.size());
+            DegreeBucketQueue<int> queue(g.size());
+            for (int v = 0 ; v < g.size() ; ++v)
+                queue.insert(v, g.degree(v), v);
+
+            for (int v ; -1 != (v = queue.pop_lowest()) ; ) {
+                order.push_back(v);
+
+                g.for_each_neighbour(v, [&] (int w) {
+                        if (queue.contains(w))
+                            queue.decrement_degree(w);
+                        });
+            }
+
+            // re-encode graph as a bit graph
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
+        }
+
+        auto found(MaxCliqueResult & local_result, const std::vector<int> & r) -> void
+        {
+            ++local_result.result_count;
+
+            if (r.size() > local_result.size) {
+                local_result.size = r.size();
+                local_result.members.clear();
+                for (auto & v : r)
+                    local_result.members.insert(order[v]);
+            }
+
+            if (params.enumerate_callback) {
+                std::vector<int> members;
+                members.reserve(r.size());
+                for (auto & v : r)
+                    members.push_back(order[v]);
+                params.enumerate_callback(members);
+            }
+        }
+
+        auto expand(
+                MaxCliqueResult & local_result,
+                std::vector<int> & r,
+                FixedBitSet<size_> & p,
+                FixedBitSet<size_> & x
+                ) -> void
+        {
+            ++local_result.nodes;
+
+            if (p.empty()) {
+                if (x.empty())
+                    found(local_result, r);
+                return;
+            }
+
+            if (params.abort->load())
+                return;
+
+            // pivot on whichever vertex of p or x has the most neighbours in
+            // p, noticing on the way if p is a clique
+            unsigned p_size = p.popcount();
+            int pivot = -1;
+            unsigned pivot_count = 0;
+            bool p_is_clique = true;
+
+            FixedBitSet<size_> p_or_x = p;
+            p_or_x.union_with(x);
+            while (! p_or_x.empty()) {
+                int u = p_or_x.first_set_bit();
+                p_or_x.unset(u);
+
+                FixedBitSet<size_> q = p;
+                unsigned count = graph.intersect_with_row_and_popcount(u, q);
+
+                if (p.test(u)) {
+                    if (count + 1 != p_size)
+                        p_is_clique = false;
+                }
+                else if (count == p_size) {
+                    // u could be added to anything we find here
+                    return;
+                }
+
+                if (-1 == pivot || count > pivot_count) {
+                    pivot = u;
+                    pivot_count = count;
+                }
+            }
+
+            // nothing in x is adjacent to all of p, so there's exactly one
+            // maximal clique here
+            if (p_is_clique) {
+                auto r_size = r.size();
+                for (FixedBitSet<size_> q = p ; ! q.empty() ; ) {
+                    int v = q.first_set_bit();
+                    q.unset(v);
+                    r.push_back(v);
+                }
+                found(local_result, r);
+                r.resize(r_size);
+                return;
+            }
+
+            // branch on everything not adjacent to the pivot
+            FixedBitSet<size_> candidates = p;
+            graph.intersect_with_row_complement(pivot, candidates);
+            while (! candidates.empty()) {
+                int v = candidates.first_set_bit();
+                candidates.unset(v);
+
+                FixedBitSet<size_> new_p = p, new_x = x;
+                graph.intersect_with_row(v, new_p);
+                graph.intersect_with_row(v, new_x);
+
+                r.push_back(v);
+                expand(local_result, r, new_p, new_x);
+                r.pop_back();
+
+                p.unset(v);
+                x.set(v);
+            }
+        }
+
+        auto run() -> MaxCliqueResult
+        {
+            auto start_time = steady_clock::now();
+
+            MaxCliqueResult result;
+            result.times.push_back(encode_time);
+            std::mutex result_mutex;
+
+            std::atomic<int> next{ 0 };
+
+            auto work = [&] () {
+                MaxCliqueResult local_result;
+
+                std::vector<int> r;
+                r.reserve(graph.size());
+
+                // we only ever see bigger v, so this can grow as we go
+                FixedBitSet<size_> earlier;
+                int earlier_up_to = 0;
+
+                for (int v ; (v = next++) < graph.size() ; ) {
+                    if (params.abort->load())
+                        break;
+
+                    // later neighbours are candidates, earlier ones are
+                    // excluded
+                    for ( ; earlier_up_to < v ; ++earlier_up_to)
+                        earlier.set(earlier_up_to);
+
+                    FixedBitSet<size_> p = graph.neighbourhood(v), x = p;
+                    p.intersect_with_complement(earlier);
+                    x.intersect_with(earlier);
+
+                    r.push_back(v);
+                    expand(local_result, r, p, x);
+                    r.pop_back();
+                }
+
+                std::unique_lock<std::mutex> guard(result_mutex);
+                result.merge(local_result);
+                result.times.push_back(duration_cast<milliseconds>(steady_clock::now() - start_time));
+            };
+
+            std::list<std::thread> threads;
+            for (unsigned t = 1 ; t < params.n_threads ; ++t)
+                threads.push_back(std::thread(work));
+
+            work();
+
+            for (auto & t : threads)
+                t.join();
+
+            return result;
+        }
+    };
+}
+
+auto parasols::bk_maximal_cliques(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    return select_graph_size<BK, MaxCliqueResult>(AllGraphSizes(), graph, params);
+}
+
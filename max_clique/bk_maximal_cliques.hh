@@ -0,0 +1,29 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_BK_MAXIMAL_CLIQUES_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_BK_MAXIMAL_CLIQUES_HH 1
+
+#include <graph/graph.hh>
+#include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
+
+namespace parasols
+{
+    /**
+     * Enumerate every maximal clique, using Bron-Kerbosch with Tomita's
+     * pivoting rule, on bitsets. Threaded.
+     *
+     * The vertices are put in degeneracy order, and threads take them in
+     * turn: the cliques whose first vertex is v are found by starting with v
+     * as the clique, its later neighbours as candidates, and its earlier
+     * neighbours as excluded, so each maximal clique is found exactly once.
+     *
+     * result_count is the number of maximal cliques, and size and members
+     * are for a largest one. If params.enumerate_callback is set, it is
+     * called with every maximal clique as soon as it is found, possibly from
+     * several threads at once. Otherwise we only count.
+     */
+    auto bk_maximal_cliques(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+}
+
+#endif
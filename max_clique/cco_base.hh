@@ -4,6 +4,9 @@
 #define PARASOLS_GUARD_MAX_CLIQUE_CCO_BASE_HH 1
 
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
+#include <graph/orbits.hh>
+#include <graph/template_voodoo.hh>
 
 #include <cco/cco.hh>
 #include <cco/cco_mixin.hh>
@@ -11,8 +14,14 @@
 #include <max_clique/max_clique_params.hh>
 #include <max_clique/print_incumbent.hh>
 #include <max_clique/cco_inference.hh>
+#include <max_clique/progress.hh>
 
+#include <algorithm>
+#include <functional>
 #include <numeric>
+#include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace parasols
 {
@@ -23,11 +32,11 @@ namespace parasols
         All
     };
 
-    template <template <CCOPermutations, CCOInference, CCOMerge, unsigned, typename VertexType_> class WhichCCO_,
-             CCOPermutations perm_, CCOInference inference_, CCOMerge merge_>
-    struct ApplyPermInferenceMerge
+    template <template <CCOPermutations, CCOInference, CCOMerge, bool, unsigned, typename VertexType_> class WhichCCO_,
+             CCOPermutations perm_, CCOInference inference_, CCOMerge merge_, bool inverse_>
+    struct ApplyPermInferenceMergeInverse
     {
-        template <unsigned size_, typename VertexType_> using Type = WhichCCO_<perm_, inference_, merge_, size_, VertexType_>;
+        template <unsigned size_, typename VertexType_> using Type = WhichCCO_<perm_, inference_, merge_, inverse_, size_, VertexType_>;
     };
 
     template <template <CCOPermutations, CCOInference, unsigned, typename VertexType_> class WhichCCO_,
@@ -37,18 +46,84 @@ namespace parasols
         template <unsigned size_, typename VertexType_> using Type = WhichCCO_<perm_, inference_, size_, VertexType_>;
     };
 
-    template <CCOPermutations perm_, CCOInference inference_, unsigned size_, typename VertexType_, typename ActualType_>
+    /**
+     * One level of the explicit stack used by CCOBase::expand. The own_
+     * buffers hold p and its colouring for levels below the top one, where
+     * they are ours rather than the caller's. The rest is where we are in the
+     * loop over p.
+     */
+    template <unsigned size_, typename VertexType_>
+    struct CCOExpandLevel
+    {
+        RangedBitSet<size_> own_p;
+        VertexArray<size_, VertexType_> own_p_order;
+        VertexArray<size_, VertexType_> own_colours;
+
+        RangedBitSet<size_> * p;
+        const VertexArray<size_, VertexType_> * p_order;
+        const VertexArray<size_, VertexType_> * colours;
+
+        int n, size, skip, stop, previous_v;
+        bool keep_going, first;
+
+        /* For progress: the weights of every branch, and of those after
+         * weight_n, given weight_best. Only kept up to date by
+         * CCOBase::fraction_done. */
+        double weight_all, weight_passed;
+        int weight_n;
+        unsigned weight_best;
+    };
+
+    /**
+     * The explicit stack used by CCOBase::expand. Levels live on the heap,
+     * and are allocated the first time the search gets that deep and then
+     * reused, so keep one of these around for as long as possible (e.g. one
+     * per thread).
+     */
+    template <unsigned size_, typename VertexType_>
+    using CCOExpandStack = std::vector<std::unique_ptr<CCOExpandLevel<size_, VertexType_> > >;
+
+    /**
+     * Once a subproblem has fewer than this many words of vertices left,
+     * and the graph is at least shrink_factor times bigger, CCOBase::expand
+     * solves it using a bit graph containing only what's left, whose rows
+     * take up a few cache lines rather than a few kilobytes.
+     */
+    const constexpr unsigned shrunk_words = 4;
+    const constexpr unsigned shrink_factor = 8;
+
+    template <CCOPermutations perm_, bool inverse_>
+    struct CCOShrunk;
+
+    /**
+     * If inverse_ is set, we look for independent sets rather than cliques in
+     * the graph we're given, so we branch on non-neighbourhoods and colour
+     * with clique covers, and never need to build the complement.
+     */
+    template <CCOPermutations perm_, CCOInference inference_, unsigned size_, typename VertexType_, typename ActualType_,
+             bool inverse_ = false>
     struct CCOBase :
-        CCOMixin<size_, VertexType_, CCOBase<perm_, inference_, size_, VertexType_, ActualType_>, false>
+        CCOMixin<size_, VertexType_, CCOBase<perm_, inference_, size_, VertexType_, ActualType_, inverse_>, inverse_>
     {
-        using CCOMixin<size_, VertexType_, CCOBase<perm_, inference_, size_, VertexType_, ActualType_>, false>::colour_class_order;
+        static_assert(! inverse_ || inference_ == CCOInference::None, "inference assumes we're looking for cliques");
+
+        using CCOMixin<size_, VertexType_, CCOBase<perm_, inference_, size_, VertexType_, ActualType_, inverse_>, inverse_>::colour_class_order;
 
         const Graph & original_graph;
-        FixedBitGraph<size_> graph;
+        BitGraph<size_> graph;
         const MaxCliqueParams & params;
         std::vector<int> order;
 
         CCOInferer<inference_, size_, VertexType_> inferer;
+        std::chrono::milliseconds encode_time;
+
+        /// If we're breaking symmetries, which orbit each vertex (in the
+        /// order of graph) is in, and what each orbit contains.
+        std::vector<int> orbit_of;
+        std::vector<std::vector<int> > orbits;
+
+        /// Does nothing unless the algorithm starts it.
+        MaxCliqueProgress progress;
 
         CCOBase(const Graph & g, const MaxCliqueParams & p) :
             original_graph(g),
@@ -60,90 +135,553 @@ namespace parasols
             params.order_function(g, order);
 
             // re-encode graph as a bit graph
-            graph.resize(g.size());
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
+
+            // symmetries would make us miss solutions when enumerating, and
+            // we can't also let domination take things out of p for us
+            if (params.break_symmetries && ! params.vertex_transitive && ! params.enumerate
+                    && inference_ != CCOInference::LazyGlobalDomination) {
+                auto start_time = std::chrono::steady_clock::now();
+
+                auto smallest = find_orbits(g);
+                std::vector<int> which(g.size(), -1);
+                orbit_of.resize(g.size());
+                for (int i = 0 ; i < g.size() ; ++i) {
+                    int & o = which[smallest[order[i]]];
+                    if (-1 == o) {
+                        o = orbits.size();
+                        orbits.emplace_back();
+                    }
+                    orbit_of[i] = o;
+                    orbits[o].push_back(i);
+                }
 
-            for (int i = 0 ; i < g.size() ; ++i)
-                for (int j = 0 ; j < g.size() ; ++j)
-                    if (g.adjacent(order[i], order[j]))
-                        graph.add_edge(i, j);
+                // no point checking, if there's nothing to find
+                if (orbits.size() == unsigned(g.size())) {
+                    orbit_of.clear();
+                    orbits.clear();
+                }
+
+                encode_time += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+            }
 
             inferer.preprocess(params, graph);
         }
 
+        /**
+         * For CCOShrunk: an empty graph of the given size, for the caller to
+         * fill in, with no order or symmetries of its own.
+         */
+        CCOBase(const Graph & g, const MaxCliqueParams & p, int size) :
+            original_graph(g),
+            params(p),
+            encode_time(0)
+        {
+            graph.resize(size);
+        }
+
+        /**
+         * At the top of the search, have we already branched on (or
+         * skipped) something in the same orbit as v? If so, everything
+         * containing v is a copy of something we've already seen.
+         */
+        auto orbit_already_seen(int v, const RangedBitSet<size_> & p) const -> bool
+        {
+            if (orbit_of.empty())
+                return false;
+
+            for (auto & w : orbits[orbit_of[v]])
+                if (w != v && ! p.test(w))
+                    return true;
+
+            return false;
+        }
+
+        /**
+         * Filter p to contain the vertices which could go with v, which are
+         * its neighbours, or its non-neighbours other than itself if
+         * inverse_. Return whether that leaves nothing.
+         */
+        auto filter_for(int v, RangedBitSet<size_> & p) const -> bool
+        {
+            if (inverse_) {
+                p.unset(v);
+                return graph.intersect_with_row_complement_and_test_empty(v, p);
+            }
+            else
+                return graph.intersect_with_row_and_test_empty(v, p);
+        }
+
+        /**
+         * Start keeping track of progress, given the top level colouring.
+         */
+        auto start_progress(
+                unsigned n_threads,
+                const VertexArray<size_, VertexType_> & initial_p_order,
+                const VertexArray<size_, VertexType_> & initial_colours,
+                MaxCliqueResult & result) -> void
+        {
+            std::vector<unsigned> colour_of(graph.size());
+            for (int n = 0 ; n < graph.size() ; ++n)
+                colour_of[initial_p_order[n]] = initial_colours[n];
+
+            progress.start(params, order, std::move(colour_of), n_threads, result);
+        }
+
+        /**
+         * When enumerating, hand c over to the callback, if there is one.
+         */
+        auto enumerate_found(const std::vector<unsigned> & c) const -> void
+        {
+            if (params.enumerate_callback) {
+                std::vector<int> members;
+                members.reserve(c.size());
+                for (auto & v : c)
+                    members.push_back(order[v]);
+                params.enumerate_callback(members);
+            }
+        }
+
+        /**
+         * Get the level of stack for a given depth, allocating it if this is
+         * the first time we've been this deep.
+         */
+        auto expand_level(CCOExpandStack<size_, VertexType_> & stack, unsigned depth) -> CCOExpandLevel<size_, VertexType_> &
+        {
+            while (stack.size() <= depth) {
+                stack.emplace_back(new CCOExpandLevel<size_, VertexType_>);
+                resize_vertex_array(stack.back()->own_p_order, graph.size());
+                resize_vertex_array(stack.back()->own_colours, graph.size());
+            }
+
+            return *stack[depth];
+        }
+
+        /**
+         * Colour the p of a child of parent, from scratch.
+         */
+        template <typename Overload_>
+        auto colour_child(
+                const Overload_ & overload,
+                const CCOExpandLevel<size_, VertexType_> &,
+                const RangedBitSet<size_> & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & colours,
+                int delta) -> void
+        {
+            colour_class_order(overload, p, p_order, colours, delta);
+        }
+
+        /**
+         * Colour the p of a child of parent, starting from the parent's
+         * colouring. Everything in p comes before the vertex the parent is
+         * branching on.
+         */
+        auto colour_child(
+                const SelectColourClassOrderOverload<CCOPermutations::Inherit> &,
+                const CCOExpandLevel<size_, VertexType_> & parent,
+                const RangedBitSet<size_> & p,
+                VertexArray<size_, VertexType_> & p_order,
+                VertexArray<size_, VertexType_> & colours,
+                int delta) -> void
+        {
+            this->colour_class_order_from_parent(p, *parent.p_order, *parent.colours, parent.n, p_order, colours, delta);
+        }
+
+        /**
+         * If p, which has been coloured as p_order and colours, is small
+         * enough, solve everything below c using a CCOShrunk, as if we'd
+         * descended into it, and return true. Otherwise return false, and p
+         * is untouched.
+         */
         template <typename... MoreArgs_>
-        auto expand(
+        auto solve_shrunk(
                 std::vector<unsigned> & c,
-                FixedBitSet<size_> & p,
-                const std::array<VertexType_, size_ * bits_per_word> & p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & colours,
+                RangedBitSet<size_> & p,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
                 std::vector<int> & position,
+                unsigned best_anywhere_value,
                 MoreArgs_ && ... more_args_
-                ) -> void
+                ) -> bool
         {
-            static_cast<ActualType_ *>(this)->increment_nodes(std::forward<MoreArgs_>(more_args_)...);
+            return solve_shrunk(std::integral_constant<bool, inference_ == CCOInference::None
+                    && (dynamic_words == size_ || size_ >= shrunk_words * shrink_factor)>(),
+                    c, p, p_order, colours, position, best_anywhere_value, std::forward<MoreArgs_>(more_args_)...);
+        }
+
+        template <typename... MoreArgs_>
+        auto solve_shrunk(
+                std::false_type,
+                std::vector<unsigned> &,
+                RangedBitSet<size_> &,
+                const VertexArray<size_, VertexType_> &,
+                const VertexArray<size_, VertexType_> &,
+                std::vector<int> &,
+                unsigned,
+                MoreArgs_ && ...
+                ) -> bool
+        {
+            return false;
+        }
 
+        template <typename... MoreArgs_>
+        auto solve_shrunk(
+                std::true_type,
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> & p,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
+                std::vector<int> & position,
+                unsigned best_anywhere_value,
+                MoreArgs_ && ... more_args_
+                ) -> bool
+        {
+            // progress is tracked at the top level, so leave that alone
+            if (! params.shrink_subproblems || c.size() < 2
+                    || unsigned(graph.size()) < shrunk_words * bits_per_word * shrink_factor)
+                return false;
+
+            unsigned n = p.popcount();
+            if (n >= shrunk_words * bits_per_word)
+                return false;
+
+            // building the graph costs about as much as colouring p again, so
+            // unless the bound says there's a fair bit of search left below
+            // here, it doesn't pay for itself
+            if (c.size() + colours[n - 1] < best_anywhere_value + 4)
+                return false;
+
+            // if we're only doing part of this level, it isn't ours to hand
+            // over (e.g. when tcco has stolen a subproblem)
             int skip = 0, stop = std::numeric_limits<int>::max();
             bool keep_going = true;
             static_cast<ActualType_ *>(this)->get_skip_and_stop(c.size(), std::forward<MoreArgs_>(more_args_)..., skip, stop, keep_going);
+            if (0 != skip || std::numeric_limits<int>::max() != stop || ! keep_going)
+                return false;
 
-            int previous_v = -1;
+            // vertices keep their relative order, and p keeps its colouring,
+            // so the search comes out the same
+            CCOShrunk<perm_, inverse_> shrunk(original_graph, params, n);
+            for (int v = p.first_set_bit() ; v != -1 ; v = p.first_set_bit()) {
+                p.unset(v);
+                shrunk.vertices.push_back(v);
+            }
 
-            // for each v in p... (v comes later)
-            bool first = true;
-            for (int n = p.popcount() - 1 ; n >= 0 ; --n) {
-                ++position.back();
+            // each row is packed a word at a time, rather than testing every
+            // pair of vertices
+            for (auto & v : shrunk.vertices)
+                p.set(v);
+            shrunk.graph.induce(graph, p, shrunk.vertices);
 
-                // bound, timeout or early exit?
-                unsigned best_anywhere_value = static_cast<ActualType_ *>(this)->get_best_anywhere_value();
-                if (c.size() + colours[n] <= best_anywhere_value || best_anywhere_value >= params.stop_after_finding || params.abort->load())
-                    return;
+            for (unsigned i = 0 ; i < n ; ++i) {
+                shrunk.p_order[i] = std::lower_bound(shrunk.vertices.begin(), shrunk.vertices.end(), unsigned(p_order[i]))
+                    - shrunk.vertices.begin();
+                shrunk.colours[i] = colours[i];
+            }
 
-                if (-1 != previous_v)
-                    inferer.propagate_no_lazy(previous_v, p);
+            shrunk.best_anywhere = [&] {
+                return static_cast<ActualType_ *>(this)->get_best_anywhere_value();
+            };
 
-                auto v = p_order[n];
-                previous_v = v;
+            shrunk.found = [&] (const std::vector<unsigned> & found_c, const std::vector<int> & found_position) {
+                static_cast<ActualType_ *>(this)->potential_new_best(found_c, found_position, more_args_...);
+            };
+
+            shrunk.solve(c, position);
+            static_cast<ActualType_ *>(this)->get_local_result(std::forward<MoreArgs_>(more_args_)...).nodes += shrunk.nodes;
+            return true;
+        }
+
+        /**
+         * Set up a level to branch on p, which has already been coloured.
+         */
+        template <typename... MoreArgs_>
+        auto start_level(
+                CCOExpandLevel<size_, VertexType_> & level,
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> & p,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
+                MoreArgs_ && ... more_args_
+                ) -> void
+        {
+            static_cast<ActualType_ *>(this)->increment_nodes(std::forward<MoreArgs_>(more_args_)...);
+            inferer.new_colouring(c.size());
+
+            level.p = &p;
+            level.p_order = &p_order;
+            level.colours = &colours;
+
+            level.skip = 0;
+            level.stop = std::numeric_limits<int>::max();
+            level.keep_going = true;
+            static_cast<ActualType_ *>(this)->get_skip_and_stop(c.size(), std::forward<MoreArgs_>(more_args_)...,
+                    level.skip, level.stop, level.keep_going);
+
+            level.previous_v = -1;
+            level.first = true;
+            level.n = p.popcount() - 1;
+            level.size = level.n + 1;
+            level.weight_n = -1;
+        }
+
+        /**
+         * How far through level have we got, weighting each branch as
+         * MaxCliqueProgress does?
+         */
+        auto fraction_done(CCOExpandLevel<size_, VertexType_> & level, unsigned c_size, unsigned best_anywhere_value) -> double
+        {
+            auto weight = [&] (int n) {
+                return MaxCliqueProgress::weight(c_size + (*level.colours)[n], best_anywhere_value);
+            };
+
+            // start again if this is new, or the weights have changed,
+            // otherwise add on whatever we've passed since last time (we go
+            // from the end backwards)
+            if (-1 == level.weight_n || level.weight_best != best_anywhere_value) {
+                level.weight_all = 0.0;
+                for (int n = 0 ; n < level.size ; ++n)
+                    level.weight_all += weight(n);
+                level.weight_passed = 0.0;
+                level.weight_n = level.size - 1;
+                level.weight_best = best_anywhere_value;
+            }
+
+            for ( ; level.weight_n > level.n ; --level.weight_n)
+                level.weight_passed += weight(level.weight_n);
+
+            return 0.0 == level.weight_all ? 1.0 : level.weight_passed / level.weight_all;
+        }
+
+        /**
+         * We've finished with taking the last vertex of c at this level, so
+         * now consider not taking it. Returns whether to keep going at this
+         * level.
+         */
+        auto finish_branch(CCOExpandLevel<size_, VertexType_> & level, std::vector<unsigned> & c) -> bool
+        {
+            level.p->unset(c.back());
+            c.pop_back();
+
+            level.keep_going = level.keep_going && (--level.stop > 0);
+            return level.keep_going;
+        }
+
+        /**
+         * Search below c, with p coloured as p_order and colours. This is
+         * the usual recursive branch and bound, but it runs from the
+         * explicit stack rather than the call stack. Descending into a child
+         * calls the descend() hook, and coming back calls ascend().
+         */
+        template <typename... MoreArgs_>
+        auto expand(
+                CCOExpandStack<size_, VertexType_> & stack,
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> & p,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
+                std::vector<int> & position,
+                MoreArgs_ && ... more_args_
+                ) -> void
+        {
+            unsigned depth = 0;
+            start_level(expand_level(stack, depth), c, p, p_order, colours, std::forward<MoreArgs_>(more_args_)...);
+
+            while (true) {
+                auto & level = *stack[depth];
+                bool descend = false;
+
+                // for each v in p... (v comes later)
+                for ( ; level.n >= 0 ; level.first = false, --level.n) {
+                    ++position.back();
+
+                    // bound, timeout or early exit?
+                    unsigned best_anywhere_value = static_cast<ActualType_ *>(this)->get_best_anywhere_value();
+                    if (c.size() + (*level.colours)[level.n] <= best_anywhere_value
+                            || best_anywhere_value >= params.stop_after_finding || params.abort->load())
+                        break;
+
+                    if (1 == c.size() && level.keep_going && progress.started())
+                        progress.partly_done(c[0], fraction_done(level, c.size(), best_anywhere_value));
+
+                    if (-1 != level.previous_v)
+                        inferer.propagate_no_lazy(level.previous_v, *level.p);
+
+                    auto v = (*level.p_order)[level.n];
+                    level.previous_v = v;
+
+                    bool skip = level.skip > 0;
+                    bool pruned = ! skip && (inferer.skip(v, *level.p) ||
+                            inferer.bound(c.size(), level.n, *level.p_order, *level.colours, best_anywhere_value,
+                                static_cast<ActualType_ *>(this)->get_local_result(std::forward<MoreArgs_>(more_args_)...)) ||
+                            (params.vertex_transitive && c.empty() && ! level.first) ||
+                            (c.empty() && orbit_already_seen(v, *level.p)) ||
+                            (c.empty() && progress.resumed(v)));
+
+                    if (skip || pruned ||
+                            ! static_cast<ActualType_ *>(this)->claim(c.size(), position.back() - 1, std::forward<MoreArgs_>(more_args_)...)) {
+                        // a top level branch we don't have to search counts
+                        // as done, as far as progress goes
+                        if (pruned && c.empty())
+                            progress.partly_done(v, 1.0);
+
+                        --level.skip;
+                        level.p->unset(v);
+                        inferer.propagate_no_skip(v, *level.p);
+                        continue;
+                    }
 
-                if (skip > 0 || inferer.skip(v, p) || (params.vertex_transitive && c.empty() && ! first)) {
-                    --skip;
-                    p.unset(v);
-                    inferer.propagate_no_skip(v, p);
-                }
-                else {
                     // consider taking v
                     c.push_back(v);
 
-                    // filter p to contain vertices adjacent to v
-                    FixedBitSet<size_> new_p = p;
-                    graph.intersect_with_row(v, new_p);
-
-                    if (new_p.empty()) {
+                    // filter p to contain vertices which could go with v
+                    auto & child = expand_level(stack, depth + 1);
+                    child.own_p = *level.p;
+                    if (filter_for(v, child.own_p)) {
                         static_cast<ActualType_ *>(this)->potential_new_best(c, position, std::forward<MoreArgs_>(more_args_)...);
+                        if (! finish_branch(level, c))
+                            break;
                     }
                     else {
                         position.push_back(0);
-                        std::array<VertexType_, size_ * bits_per_word> new_p_order;
-                        std::array<VertexType_, size_ * bits_per_word> new_colours;
-                        colour_class_order(SelectColourClassOrderOverload<perm_>(), new_p, new_p_order, new_colours, best_anywhere_value - c.size());
-                        keep_going = static_cast<ActualType_ *>(this)->recurse(
-                                c, new_p, new_p_order, new_colours, position, std::forward<MoreArgs_>(more_args_)...) && keep_going;
-                        position.pop_back();
-                    }
-
-                    // now consider not taking v
-                    c.pop_back();
-                    p.unset(v);
+                        colour_child(SelectColourClassOrderOverload<perm_>(), level, child.own_p, child.own_p_order, child.own_colours,
+                                best_anywhere_value - c.size());
 
-                    keep_going = keep_going && (--stop > 0);
+                        if (solve_shrunk(c, child.own_p, child.own_p_order, child.own_colours, position, best_anywhere_value,
+                                    std::forward<MoreArgs_>(more_args_)...)) {
+                            position.pop_back();
+                            if (! finish_branch(level, c))
+                                break;
+                            continue;
+                        }
 
-                    if (! keep_going)
+                        static_cast<ActualType_ *>(this)->descend(c, child.own_p, std::forward<MoreArgs_>(more_args_)...);
+                        start_level(child, c, child.own_p, child.own_p_order, child.own_colours, std::forward<MoreArgs_>(more_args_)...);
+                        descend = true;
                         break;
+                    }
+                }
+
+                if (descend) {
+                    ++depth;
+                    continue;
                 }
 
-                first = false;
+                // this level is done, so go back to where our parent took v
+                if (0 == depth)
+                    break;
+
+                auto & parent = *stack[--depth];
+                parent.keep_going = static_cast<ActualType_ *>(this)->ascend(c, std::forward<MoreArgs_>(more_args_)...) && parent.keep_going;
+                position.pop_back();
+
+                if (finish_branch(parent, c)) {
+                    parent.first = false;
+                    --parent.n;
+                }
+                else
+                    parent.n = -1;
             }
         }
     };
+
+    /**
+     * Solves what is left of a bigger search, once it has shrunk to fit a
+     * small bit graph (see CCOBase::solve_shrunk). Our c starts off as the
+     * caller's, so bounds work as usual, and anything found is handed back
+     * using the caller's vertices.
+     */
+    template <CCOPermutations perm_, bool inverse_>
+    struct CCOShrunk :
+        CCOBase<perm_, CCOInference::None, shrunk_words, typename IndexSizes<shrunk_words>::Type, CCOShrunk<perm_, inverse_>, inverse_>
+    {
+        using VertexType = typename IndexSizes<shrunk_words>::Type;
+        using Base = CCOBase<perm_, CCOInference::None, shrunk_words, VertexType, CCOShrunk<perm_, inverse_>, inverse_>;
+
+        using Base::graph;
+        using Base::expand;
+
+        /// The caller's vertex for each of ours.
+        std::vector<unsigned> vertices;
+
+        std::function<unsigned ()> best_anywhere;
+        std::function<void (const std::vector<unsigned> &, const std::vector<int> &)> found;
+
+        unsigned long long nodes = 0;
+
+        /// How much of c is the caller's.
+        unsigned prefix = 0;
+
+        /// For handing c back.
+        std::vector<unsigned> caller_c;
+
+        CCOShrunk(const Graph & g, const MaxCliqueParams & p, int size) :
+            Base(g, p, size)
+        {
+            vertices.reserve(size);
+        }
+
+        /// The caller's colouring, using our vertices.
+        VertexArray<shrunk_words, VertexType> p_order;
+        VertexArray<shrunk_words, VertexType> colours;
+
+        auto solve(std::vector<unsigned> & c, std::vector<int> & position) -> void
+        {
+            prefix = c.size();
+
+            RangedBitSet<shrunk_words> p;
+            p.resize(graph.size());
+            p.set_up_to(graph.size());
+
+            static thread_local CCOExpandStack<shrunk_words, VertexType> stack;
+            expand(stack, c, p, p_order, colours, position);
+        }
+
+        auto increment_nodes() -> void
+        {
+            ++nodes;
+        }
+
+        auto descend(std::vector<unsigned> &, RangedBitSet<shrunk_words> &) -> void
+        {
+        }
+
+        auto ascend(std::vector<unsigned> &) -> bool
+        {
+            return true;
+        }
+
+        auto potential_new_best(const std::vector<unsigned> & c, const std::vector<int> & position) -> void
+        {
+            caller_c.assign(c.begin(), c.end());
+            for (unsigned i = prefix ; i < caller_c.size() ; ++i)
+                caller_c[i] = vertices[caller_c[i]];
+            found(caller_c, position);
+        }
+
+        auto get_best_anywhere_value() -> unsigned
+        {
+            return best_anywhere();
+        }
+
+        auto get_local_result() -> MaxCliqueResult &
+        {
+            return local_result;
+        }
+
+        auto get_skip_and_stop(unsigned, int &, int &, bool &) -> void
+        {
+        }
+
+        auto claim(unsigned, int) -> bool
+        {
+            return true;
+        }
+
+        /// Only for the inferer, which doesn't do anything.
+        MaxCliqueResult local_result;
+    };
 }
 
 #endif
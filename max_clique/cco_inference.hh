@@ -4,16 +4,23 @@
 #define PARASOLS_GUARD_MAX_CLIQUE_CCO_INFERENCE_HH 1
 
 #include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
 #include <max_clique/print_incumbent.hh>
 
 #include <graph/bit_graph.hh>
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
 namespace parasols
 {
     enum class CCOInference
     {
         None,
-        LazyGlobalDomination      // remove from p, lazy
+        LazyGlobalDomination,     // remove from p, lazy
+        InfraChromatic            // MaxSAT-style colour bound
     };
 
     template <CCOInference inference_, unsigned size_, typename VertexType_>
@@ -22,71 +29,429 @@ namespace parasols
     template <unsigned size_, typename VertexType_>
     struct CCOInferer<CCOInference::None, size_, VertexType_>
     {
-        void preprocess(const MaxCliqueParams &, FixedBitGraph<size_> &)
+        void preprocess(const MaxCliqueParams &, BitGraph<size_> &)
+        {
+        }
+
+        void new_colouring(unsigned)
         {
         }
 
-        void propagate_no_skip(VertexType_, FixedBitSet<size_> &)
+        void propagate_no_skip(VertexType_, RangedBitSet<size_> &)
         {
         }
 
-        void propagate_no_lazy(VertexType_, FixedBitSet<size_> &)
+        void propagate_no_lazy(VertexType_, RangedBitSet<size_> &)
         {
         }
 
-        auto skip(VertexType_, FixedBitSet<size_> &) -> bool
+        auto skip(VertexType_, RangedBitSet<size_> &) -> bool
+        {
+            return false;
+        }
+
+        auto bound(unsigned, int, const VertexArray<size_, VertexType_> &, const VertexArray<size_, VertexType_> &,
+                unsigned, MaxCliqueResult &) -> bool
         {
             return false;
         }
     };
 
+    /**
+     * When we decide not to take v, anything whose neighbourhood (other than
+     * v) lies inside v's neighbourhood can go from p too, because swapping it
+     * for v gives a clique we've already looked at.
+     *
+     * Which vertices v dominates is worked out the first time we need it,
+     * and then kept. The results are shared between threads: whoever gets
+     * to a vertex first works it out and publishes it, and anyone who wants
+     * it before it is ready just goes without, which is always safe. So
+     * nobody ever waits, and nothing is worked out twice.
+     */
     template <unsigned size_, typename VertexType_>
     struct CCOInferer<CCOInference::LazyGlobalDomination, size_, VertexType_>
     {
-        const FixedBitGraph<size_> * graph;
-        std::vector<std::pair<bool, FixedBitSet<size_> > > unsets;
+        enum : int { unknown, working, known };
 
-        void preprocess(const MaxCliqueParams &, FixedBitGraph<size_> & g)
+        const BitGraph<size_> * graph;
+        std::vector<BitSet<size_> > unsets;
+        std::unique_ptr<std::atomic<int> []> states;
+
+        void preprocess(const MaxCliqueParams &, BitGraph<size_> & g)
         {
             graph = &g;
+
+            unsets.resize(g.size());
+            for (auto & u : unsets)
+                u.resize(g.size());
+
+            states.reset(new std::atomic<int>[g.size()]);
+            for (int v = 0 ; v < g.size() ; ++v)
+                states[v].store(unknown, std::memory_order_relaxed);
         }
 
-        void propagate_no_skip(VertexType_ v, FixedBitSet<size_> & p)
+        void new_colouring(unsigned)
         {
-            really_propagate_no(v, p);
         }
 
-        void propagate_no_lazy(VertexType_ v, FixedBitSet<size_> & p)
+        void propagate_no_skip(VertexType_ v, RangedBitSet<size_> & p)
         {
             really_propagate_no(v, p);
         }
 
-        void really_propagate_no(VertexType_ v, FixedBitSet<size_> & p)
+        void propagate_no_lazy(VertexType_ v, RangedBitSet<size_> & p)
         {
-            if (! unsets[v].first) {
-                unsets[v].first = true;
+            really_propagate_no(v, p);
+        }
 
-                FixedBitSet<size_> nv = graph->neighbourhood(v);
+        void really_propagate_no(VertexType_ v, RangedBitSet<size_> & p)
+        {
+            int state = states[v].load(std::memory_order_acquire);
+            if (unknown == state && states[v].compare_exchange_strong(state, working, std::memory_order_acquire)) {
+                BitSet<size_> nv = graph->neighbourhood(v);
 
                 for (int i = 0 ; i < graph->size() ; ++i) {
                     if (i == v)
                         continue;
 
-                    FixedBitSet<size_> niv = graph->neighbourhood(i);
+                    BitSet<size_> niv = graph->neighbourhood(i);
                     niv.intersect_with_complement(nv);
                     niv.unset(v);
                     if (niv.empty())
-                        unsets[v].second.set(i);
+                        unsets[v].set(i);
                 }
+
+                states[v].store(known, std::memory_order_release);
+                state = known;
             }
 
-            p.intersect_with_complement(unsets[v].second);
+            if (known == state)
+                p.intersect_with_complement(unsets[v]);
         }
 
-        auto skip(VertexType_ v, FixedBitSet<size_> & p) -> bool
+        auto skip(VertexType_ v, RangedBitSet<size_> & p) -> bool
         {
             return ! p.test(v);
         }
+
+        auto bound(unsigned, int, const VertexArray<size_, VertexType_> &, const VertexArray<size_, VertexType_> &,
+                unsigned, MaxCliqueResult &) -> bool
+        {
+            return false;
+        }
+    };
+
+    /**
+     * Tighten the colour bound for a branching vertex, in the style of the
+     * MaxSAT based (infra-chromatic) bounds of IncMaxCLQ.
+     *
+     * Say v is at position n and has colour k. Anything in the subtree of v
+     * is v plus at most one vertex from each of the colour classes 1 to k - 1,
+     * restricted to v's neighbours. Treat each of those classes as a clause
+     * saying "take one of these". If unit propagation, or a failed literal
+     * test on a class with two members, shows some set of classes can't all
+     * be satisfied together, then between them they lose at least one from
+     * the bound. If we find enough disjoint such sets to bring the bound
+     * down to the incumbent, v can't lead to anything better.
+     *
+     * The colour classes of a node are turned into bitsets the first time we
+     * try a vertex there, and reused for its other vertices. Everything else
+     * is worked out from scratch for each vertex. All our working space is
+     * thread local, so one of these can be shared by several threads.
+     */
+    template <unsigned size_, typename VertexType_>
+    struct CCOInferer<CCOInference::InfraChromatic, size_, VertexType_>
+    {
+        /**
+         * Only try vertices whose colour is at most this far above what they
+         * would need to be pruned. Further out, we rarely find enough
+         * inconsistent sets to be worth the search.
+         */
+        static const constexpr int max_excess_colours = 1;
+
+        /**
+         * How many failed literal tests to try, when unit propagation alone
+         * doesn't find an inconsistent set.
+         */
+        static const constexpr int max_failed_literals = 2;
+
+        const BitGraph<size_> * graph;
+
+        /**
+         * The colour classes of the node at some depth, if we've built them
+         * since it was coloured.
+         */
+        struct Classes
+        {
+            bool built = false;
+            int number_built = 0;
+            std::vector<RangedBitSet<size_> > members;
+        };
+
+        /**
+         * Working space for one vertex. Class j, restricted to v's
+         * neighbours, is original[j], with working[j] being what's left of it
+         * after propagation and sizes[j] how big that is.
+         */
+        struct Workspace
+        {
+            std::vector<Classes> depths;
+            std::vector<RangedBitSet<size_> > original, working;
+            std::vector<int> original_sizes, sizes;
+            std::vector<char> usable, done, queued, in_conflict;
+            std::vector<std::vector<int> > causes;
+            std::vector<int> queue, conflict, first_conflict;
+        };
+
+        static auto workspace() -> Workspace &
+        {
+            static thread_local Workspace w;
+            return w;
+        }
+
+        void preprocess(const MaxCliqueParams &, BitGraph<size_> & g)
+        {
+            graph = &g;
+        }
+
+        void new_colouring(unsigned c_popcount)
+        {
+            auto & w = workspace();
+            if (w.depths.size() > c_popcount)
+                w.depths[c_popcount].built = false;
+        }
+
+        void propagate_no_skip(VertexType_, RangedBitSet<size_> &)
+        {
+        }
+
+        void propagate_no_lazy(VertexType_, RangedBitSet<size_> &)
+        {
+        }
+
+        auto skip(VertexType_, RangedBitSet<size_> &) -> bool
+        {
+            return false;
+        }
+
+        /**
+         * Make sure w has room for classes 1 to k - 1.
+         */
+        auto make_room(Workspace & w, std::vector<RangedBitSet<size_> > & sets, int k) -> void
+        {
+            while (sets.size() < unsigned(k)) {
+                sets.emplace_back();
+                sets.back().resize(graph->size());
+            }
+
+            if (w.original_sizes.size() < unsigned(k)) {
+                w.original_sizes.resize(k);
+                w.sizes.resize(k);
+                w.usable.resize(k);
+                w.done.resize(k);
+                w.queued.resize(k);
+                w.in_conflict.resize(k);
+                w.causes.resize(k);
+            }
+        }
+
+        /**
+         * Add class j, and everything which led to it shrinking, to
+         * w.conflict.
+         */
+        auto explain(Workspace & w, int j) -> void
+        {
+            if (w.in_conflict[j])
+                return;
+
+            w.in_conflict[j] = true;
+            w.conflict.push_back(j);
+            for (auto & k : w.causes[j])
+                explain(w, k);
+        }
+
+        /**
+         * Unit propagate over the usable classes 1 to k - 1. If forced_class
+         * isn't -1, that class is first cut down to just forced_vertex.
+         * Returns true, with the classes involved in w.conflict, if some
+         * class ends up empty.
+         */
+        auto propagate(Workspace & w, int k, int forced_class, int forced_vertex) -> bool
+        {
+            w.queue.clear();
+            w.conflict.clear();
+
+            for (int j = 1 ; j < k ; ++j) {
+                if (! w.usable[j])
+                    continue;
+
+                w.working[j] = w.original[j];
+                w.sizes[j] = w.original_sizes[j];
+                w.done[j] = false;
+                w.queued[j] = false;
+                w.in_conflict[j] = false;
+                w.causes[j].clear();
+            }
+
+            if (-1 != forced_class) {
+                w.working[forced_class].unset_all();
+                w.working[forced_class].set(forced_vertex);
+                w.sizes[forced_class] = 1;
+            }
+
+            for (int j = 1 ; j < k ; ++j) {
+                if (! w.usable[j])
+                    continue;
+
+                if (0 == w.sizes[j]) {
+                    explain(w, j);
+                    return true;
+                }
+                else if (1 == w.sizes[j]) {
+                    w.queued[j] = true;
+                    w.queue.push_back(j);
+                }
+            }
+
+            for (unsigned q = 0 ; q < w.queue.size() ; ++q) {
+                int j = w.queue[q];
+                w.done[j] = true;
+                int u = w.working[j].first_set_bit();
+
+                for (int i = 1 ; i < k ; ++i) {
+                    if (! w.usable[i] || w.done[i])
+                        continue;
+
+                    // keep only the members of class i which are adjacent to u
+                    int size = graph->intersect_with_row_and_popcount(u, w.working[i]);
+                    if (size == w.sizes[i])
+                        continue;
+
+                    w.sizes[i] = size;
+                    w.causes[i].push_back(j);
+
+                    if (0 == size) {
+                        explain(w, i);
+                        return true;
+                    }
+                    else if (1 == size && ! w.queued[i]) {
+                        w.queued[i] = true;
+                        w.queue.push_back(i);
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * Can we find one more set of classes which can't all be satisfied,
+         * disjoint from those we've already found? If so, mark it as
+         * unusable.
+         */
+        auto find_inconsistent_set(Workspace & w, int k) -> bool
+        {
+            if (! propagate(w, k, -1, -1)) {
+                // failed literals: a class with two members, where taking
+                // either member leads to a conflict
+                bool found = false;
+                int tried = 0;
+                for (int j = 1 ; j < k && ! found && tried < max_failed_literals ; ++j) {
+                    if (! w.usable[j] || 2 != w.original_sizes[j])
+                        continue;
+
+                    ++tried;
+
+                    int a = w.original[j].first_set_bit();
+                    if (! propagate(w, k, j, a))
+                        continue;
+                    w.first_conflict = w.conflict;
+
+                    w.original[j].unset(a);
+                    int b = w.original[j].first_set_bit();
+                    w.original[j].set(a);
+                    if (! propagate(w, k, j, b))
+                        continue;
+
+                    for (auto & i : w.first_conflict)
+                        w.usable[i] = false;
+                    w.usable[j] = false;
+                    found = true;
+                }
+
+                if (! found)
+                    return false;
+            }
+
+            for (auto & i : w.conflict)
+                w.usable[i] = false;
+
+            return true;
+        }
+
+        /**
+         * Can the vertex at position n be thrown away, because there's no
+         * way it can beat best_anywhere_value?
+         */
+        auto bound(
+                unsigned c_popcount,
+                int n,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
+                unsigned best_anywhere_value,
+                MaxCliqueResult & result) -> bool
+        {
+            if (best_anywhere_value < c_popcount)
+                return false;
+
+            int k = colours[n];
+            int needed = c_popcount + k - best_anywhere_value;
+            if (needed <= 0 || needed > max_excess_colours || needed >= k)
+                return false;
+
+            auto start_time = std::chrono::steady_clock::now();
+            ++result.inference_attempts;
+
+            auto & w = workspace();
+
+            // colour classes for this node. Colours don't go down along
+            // p_order, and we're only asked about smaller colours as we go,
+            // so whatever we build first covers everything we'll need here.
+            if (w.depths.size() <= c_popcount)
+                w.depths.resize(c_popcount + 1);
+            auto & classes = w.depths[c_popcount];
+            if (! classes.built) {
+                make_room(w, classes.members, k);
+                for (int j = 1 ; j < classes.number_built ; ++j)
+                    classes.members[j].unset_all();
+
+                for (int x = 0 ; x < n && int(colours[x]) < k ; ++x)
+                    classes.members[colours[x]].set(p_order[x]);
+
+                classes.built = true;
+                classes.number_built = k;
+            }
+
+            // the neighbours of v from each of those classes
+            int v = p_order[n];
+            make_room(w, w.original, k);
+            make_room(w, w.working, k);
+            for (int j = 1 ; j < k ; ++j) {
+                w.original[j] = classes.members[j];
+                w.original_sizes[j] = graph->intersect_with_row_and_popcount(v, w.original[j]);
+                w.usable[j] = true;
+            }
+
+            bool pruned = true;
+            for (int found = 0 ; found < needed && pruned ; ++found)
+                pruned = find_inconsistent_set(w, k);
+
+            if (pruned)
+                ++result.inference_prunes;
+            result.inference_time += std::chrono::steady_clock::now() - start_time;
+
+            return pruned;
+        }
     };
 }
 
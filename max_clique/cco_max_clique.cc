@@ -15,10 +15,10 @@ using namespace parasols;
 
 namespace
 {
-    template <CCOPermutations perm_, CCOInference inference_, CCOMerge merge_, unsigned size_, typename VertexType_>
-    struct CCO : CCOBase<perm_, inference_, size_, VertexType_, CCO<perm_, inference_, merge_, size_, VertexType_> >
+    template <CCOPermutations perm_, CCOInference inference_, CCOMerge merge_, bool inverse_, unsigned size_, typename VertexType_>
+    struct CCO : CCOBase<perm_, inference_, size_, VertexType_, CCO<perm_, inference_, merge_, inverse_, size_, VertexType_>, inverse_>
     {
-        using Base = CCOBase<perm_, inference_, size_, VertexType_, CCO<perm_, inference_, merge_, size_, VertexType_> >;
+        using Base = CCOBase<perm_, inference_, size_, VertexType_, CCO<perm_, inference_, merge_, inverse_, size_, VertexType_>, inverse_>;
 
         using Base::CCOBase;
 
@@ -27,7 +27,11 @@ namespace
         using Base::params;
         using Base::expand;
         using Base::order;
+        using Base::encode_time;
         using Base::colour_class_order;
+        using Base::enumerate_found;
+        using Base::progress;
+        using Base::start_progress;
 
         MaxCliqueResult result;
 
@@ -36,11 +40,13 @@ namespace
         auto run() -> MaxCliqueResult
         {
             result.size = params.initial_bound;
+            result.times.push_back(encode_time);
 
             std::vector<unsigned> c;
             c.reserve(graph.size());
 
-            FixedBitSet<size_> p; // potential additions
+            RangedBitSet<size_> p; // potential additions
+            p.resize(graph.size());
             p.set_up_to(graph.size());
 
             std::vector<int> positions;
@@ -48,15 +54,23 @@ namespace
             positions.push_back(0);
 
             // initial colouring
-            std::array<VertexType_, size_ * bits_per_word> initial_p_order;
-            std::array<VertexType_, size_ * bits_per_word> initial_colours;
+            VertexArray<size_, VertexType_> initial_p_order;
+            VertexArray<size_, VertexType_> initial_colours;
+            resize_vertex_array(initial_p_order, graph.size());
+            resize_vertex_array(initial_colours, graph.size());
             colour_class_order(SelectColourClassOrderOverload<perm_>(), p, initial_p_order, initial_colours, 0);
             result.initial_colour_bound = initial_colours[graph.size() - 1];
 
             print_position(params, "initial colouring used " + std::to_string(result.initial_colour_bound), std::vector<int>{ });
 
+            start_progress(1, initial_p_order, initial_colours, result);
+
             // go!
-            expand(c, p, initial_p_order, initial_colours, positions);
+            CCOExpandStack<size_, VertexType_> stack;
+            expand(stack, c, p, initial_p_order, initial_colours, positions);
+
+            progress.idle(0, result.nodes);
+            progress.stop(result);
 
             // hack for enumerate
             if (params.enumerate)
@@ -67,18 +81,26 @@ namespace
 
         auto increment_nodes() -> void
         {
-            ++result.nodes;
+            // every so often, say how far we've got, for progress reports
+            if (0 == (++result.nodes & 0xffff))
+                progress.counted(0, result.nodes);
+        }
+
+        auto descend(
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> &) -> void
+        {
+            if (1 == c.size())
+                progress.starting(0, c.back());
         }
 
-        auto recurse(
-                std::vector<unsigned> & c,                       // current candidate clique
-                FixedBitSet<size_> & p,
-                const std::array<VertexType_, size_ * bits_per_word> & p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & colours,
-                std::vector<int> & position
-                ) -> bool
+        auto ascend(
+                std::vector<unsigned> & c) -> bool
         {
-            expand(c, p, p_order, colours, position);
+            // if we didn't abort, we're done with this top level branch
+            if (1 == c.size() && ! params.abort->load())
+                progress.finished(0, c.back(), result.nodes);
+
             return true;
         }
 
@@ -88,13 +110,20 @@ namespace
         {
             switch (merge_) {
                 case CCOMerge::None:
-                    if (c.size() > result.size) {
-                        if (params.enumerate) {
+                    if (params.enumerate) {
+                        // result.size stays at initial_bound, so we keep
+                        // counting cliques of the same size, and we keep the
+                        // first as a witness
+                        if (c.size() > params.initial_bound) {
                             ++result.result_count;
-                            result.size = c.size() - 1;
+                            if (result.members.empty())
+                                for (auto & v : c)
+                                    result.members.insert(order[v]);
+                            enumerate_found(c);
                         }
-                        else
-                            result.size = c.size();
+                    }
+                    else if (c.size() > result.size) {
+                        result.size = c.size();
 
                         result.members.clear();
                         for (auto & v : c)
@@ -148,6 +177,9 @@ namespace
                     }
                     break;
             }
+
+            if (! params.enumerate)
+                progress.new_incumbent(result.members);
         }
 
         auto get_best_anywhere_value() -> unsigned
@@ -155,27 +187,49 @@ namespace
             return result.size;
         }
 
+        auto get_local_result() -> MaxCliqueResult &
+        {
+            return result;
+        }
+
         auto get_skip_and_stop(unsigned, int &, int &, bool &) -> void
         {
         }
+
+        auto claim(unsigned, int) -> bool
+        {
+            return true;
+        }
     };
 }
 
 template <CCOPermutations perm_, CCOInference inference_, CCOMerge merge_>
 auto parasols::cco_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
 {
-    return select_graph_size<ApplyPermInferenceMerge<CCO, perm_, inference_, merge_>::template Type, MaxCliqueResult>(
-            AllGraphSizes(), graph, params);
+    return select_graph_size<ApplyPermInferenceMergeInverse<CCO, perm_, inference_, merge_, false>::template Type, MaxCliqueResult>(
+            AllGraphSizesAndDynamic(), graph, params);
+}
+
+template <CCOPermutations perm_>
+auto parasols::cco_max_independent_set(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    return select_graph_size<ApplyPermInferenceMergeInverse<CCO, perm_, CCOInference::None, CCOMerge::None, true>::template Type, MaxCliqueResult>(
+            AllGraphSizesAndDynamic(), graph, params);
 }
 
 template auto parasols::cco_max_clique<CCOPermutations::None, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::Defer1, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::Inherit, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairAll, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairAllDefer1, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairSelected, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairSelectedDefer1, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairSelectedFast, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::RepairAllFast, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::RepairAllBitSet, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::RepairAllDefer1BitSet, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::RepairSelectedBitSet, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::RepairSelectedDefer1BitSet, CCOInference::None, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 
 template auto parasols::cco_max_clique<CCOPermutations::None, CCOInference::None, CCOMerge::Previous>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::Defer1, CCOInference::None, CCOMerge::Previous>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
@@ -185,3 +239,9 @@ template auto parasols::cco_max_clique<CCOPermutations::Defer1, CCOInference::No
 
 template auto parasols::cco_max_clique<CCOPermutations::None, CCOInference::LazyGlobalDomination, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::cco_max_clique<CCOPermutations::Defer1, CCOInference::LazyGlobalDomination, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
+template auto parasols::cco_max_clique<CCOPermutations::None, CCOInference::InfraChromatic, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_clique<CCOPermutations::Defer1, CCOInference::InfraChromatic, CCOMerge::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
+template auto parasols::cco_max_independent_set<CCOPermutations::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::cco_max_independent_set<CCOPermutations::Defer1>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
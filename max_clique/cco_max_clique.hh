@@ -16,6 +16,14 @@ namespace parasols
      */
     template <CCOPermutations, CCOInference, CCOMerge>
     auto cco_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+
+    /**
+     * Super duper max independent set algorithm. This works on the graph as
+     * given, rather than needing its complement. Results are independent
+     * sets, not cliques.
+     */
+    template <CCOPermutations>
+    auto cco_max_independent_set(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
 }
 
 #endif
@@ -0,0 +1,105 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/checkpoint.hh>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace parasols;
+
+CheckpointFileError::CheckpointFileError(const std::string & filename, const std::string & message) throw () :
+    _what("Error with checkpoint file '" + filename + "': " + message)
+{
+}
+
+auto CheckpointFileError::what() const throw () -> const char *
+{
+    return _what.c_str();
+}
+
+namespace
+{
+    const std::string magic = "parasols max clique checkpoint";
+
+    auto read_set(const std::string & filename, std::istream & infile, const std::string & what) -> std::set<int>
+    {
+        std::string line;
+        if (! std::getline(infile, line))
+            throw CheckpointFileError{ filename, "expected " + what + " line" };
+
+        std::istringstream words{ line };
+        std::string word;
+        unsigned count;
+        if (! (words >> word >> count) || word != what)
+            throw CheckpointFileError{ filename, "bad " + what + " line '" + line + "'" };
+
+        std::set<int> result;
+        for (int v ; words >> v ; )
+            result.insert(v);
+
+        if (result.size() != count)
+            throw CheckpointFileError{ filename, "wrong number of vertices on " + what + " line" };
+
+        return result;
+    }
+
+    auto write_set(std::ostream & outfile, const std::string & what, const std::set<int> & set) -> void
+    {
+        outfile << what << " " << set.size();
+        for (auto & v : set)
+            outfile << " " << v;
+        outfile << std::endl;
+    }
+}
+
+auto parasols::read_max_clique_checkpoint(const std::string & filename) -> MaxCliqueCheckpoint
+{
+    MaxCliqueCheckpoint result;
+
+    std::ifstream infile{ filename };
+    if (! infile)
+        throw CheckpointFileError{ filename, "unable to open file" };
+
+    std::string line;
+    if (! std::getline(infile, line) || line != magic)
+        throw CheckpointFileError{ filename, "not a checkpoint file" };
+
+    if (! std::getline(infile, line) || 0 != line.compare(0, 4, "key "))
+        throw CheckpointFileError{ filename, "expected key line" };
+    result.key = line.substr(4);
+
+    if (! std::getline(infile, line) || 0 != line.compare(0, 6, "nodes "))
+        throw CheckpointFileError{ filename, "expected nodes line" };
+    try {
+        result.nodes = std::stoull(line.substr(6));
+    }
+    catch (const std::exception &) {
+        throw CheckpointFileError{ filename, "bad nodes line '" + line + "'" };
+    }
+
+    result.members = read_set(filename, infile, "incumbent");
+    result.done = read_set(filename, infile, "done");
+
+    return result;
+}
+
+auto parasols::write_max_clique_checkpoint(const std::string & filename, const MaxCliqueCheckpoint & checkpoint) -> void
+{
+    std::string temporary = filename + ".tmp";
+
+    {
+        std::ofstream outfile{ temporary };
+        outfile << magic << std::endl;
+        outfile << "key " << checkpoint.key << std::endl;
+        outfile << "nodes " << checkpoint.nodes << std::endl;
+        write_set(outfile, "incumbent", checkpoint.members);
+        write_set(outfile, "done", checkpoint.done);
+
+        if (! outfile)
+            throw CheckpointFileError{ temporary, "unable to write file" };
+    }
+
+    if (0 != std::rename(temporary.c_str(), filename.c_str()))
+        throw CheckpointFileError{ filename, "unable to replace file" };
+}
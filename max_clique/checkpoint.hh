@@ -0,0 +1,59 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_CHECKPOINT_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_CHECKPOINT_HH 1
+
+#include <exception>
+#include <set>
+#include <string>
+
+namespace parasols
+{
+    /**
+     * Thrown if we can't read or write a checkpoint file, or if it doesn't
+     * make sense.
+     */
+    class CheckpointFileError :
+        public std::exception
+    {
+        private:
+            std::string _what;
+
+        public:
+            CheckpointFileError(const std::string & filename, const std::string & message) throw ();
+
+            auto what() const throw () -> const char *;
+    };
+
+    /**
+     * How far a max clique search had got. Vertices are numbered as in the
+     * graph given to the algorithm.
+     */
+    struct MaxCliqueCheckpoint
+    {
+        /// What was being solved, so we don't resume something else.
+        std::string key;
+
+        /// How many nodes had been searched.
+        unsigned long long nodes = 0;
+
+        /// The best clique found.
+        std::set<int> members;
+
+        /// Vertices whose top level branches have been finished.
+        std::set<int> done;
+    };
+
+    /**
+     * Read a checkpoint file.
+     */
+    auto read_max_clique_checkpoint(const std::string & filename) -> MaxCliqueCheckpoint;
+
+    /**
+     * Write a checkpoint file. We write to a temporary file and then rename
+     * it, so if we're killed half way through, the old one is still there.
+     */
+    auto write_max_clique_checkpoint(const std::string & filename, const MaxCliqueCheckpoint &) -> void;
+}
+
+#endif
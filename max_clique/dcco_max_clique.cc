@@ -0,0 +1,294 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/dcco_max_clique.hh>
+#include <max_clique/cco_base.hh>
+#include <max_clique/print_incumbent.hh>
+
+#include <threads/atomic_incumbent.hh>
+
+#include <graph/template_voodoo.hh>
+#include <graph/degree_bucket_queue.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using namespace parasols;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+    /**
+     * The ego network a thread is currently working on: v, and a small
+     * graph made from the neighbours of v which come after it.
+     */
+    struct Ego
+    {
+        const MaxCliqueParams & params;
+        AtomicIncumbent & best_anywhere;
+        MaxCliqueResult & local_result;
+
+        int v;
+
+        /// Vertex i of the small graph is vertices[i] of the big graph.
+        std::vector<int> vertices;
+
+        /**
+         * We've found a clique made up of v and these vertices of the small
+         * graph.
+         */
+        auto found(const std::vector<int> & members, const std::vector<int> & position) -> void
+        {
+            unsigned size = members.size() + 1;
+
+            if (params.enumerate) {
+                if (size <= params.initial_bound)
+                    return;
+
+                ++local_result.result_count;
+                if (params.enumerate_callback) {
+                    std::vector<int> clique{ v };
+                    for (auto & m : members)
+                        clique.push_back(vertices[m]);
+                    params.enumerate_callback(clique);
+                }
+
+                // keep the first as a witness
+                if (! local_result.members.empty())
+                    return;
+            }
+            else if (! best_anywhere.update(size))
+                return;
+
+            local_result.size = size;
+            local_result.members.clear();
+            local_result.members.insert(v);
+            for (auto & m : members)
+                local_result.members.insert(vertices[m]);
+
+            if (! params.enumerate)
+                print_incumbent(params, size, position);
+        }
+    };
+
+    template <CCOPermutations perm_, unsigned size_, typename VertexType_>
+    struct EgoCCO : CCOBase<perm_, CCOInference::None, size_, VertexType_, EgoCCO<perm_, size_, VertexType_> >
+    {
+        using Base = CCOBase<perm_, CCOInference::None, size_, VertexType_, EgoCCO<perm_, size_, VertexType_> >;
+
+        using Base::graph;
+        using Base::expand;
+        using Base::order;
+        using Base::colour_class_order;
+
+        Ego & ego;
+
+        EgoCCO(const Graph & g, const MaxCliqueParams & p, Ego & e) :
+            Base(g, p),
+            ego(e)
+        {
+        }
+
+        auto run() -> void
+        {
+            std::vector<unsigned> c;
+            c.reserve(graph.size());
+
+            RangedBitSet<size_> p; // potential additions
+            p.resize(graph.size());
+            p.set_up_to(graph.size());
+
+            std::vector<int> positions;
+            positions.reserve(graph.size() + 1);
+            positions.push_back(ego.v);
+            positions.push_back(0);
+
+            // initial colouring
+            VertexArray<size_, VertexType_> initial_p_order;
+            VertexArray<size_, VertexType_> initial_colours;
+            resize_vertex_array(initial_p_order, graph.size());
+            resize_vertex_array(initial_colours, graph.size());
+            colour_class_order(SelectColourClassOrderOverload<perm_>(), p, initial_p_order, initial_colours, 0);
+
+            // go!
+            CCOExpandStack<size_, VertexType_> stack;
+            expand(stack, c, p, initial_p_order, initial_colours, positions);
+        }
+
+        auto increment_nodes() -> void
+        {
+            ++ego.local_result.nodes;
+        }
+
+        auto descend(
+                std::vector<unsigned> &,
+                RangedBitSet<size_> &) -> void
+        {
+        }
+
+        auto ascend(
+                std::vector<unsigned> &) -> bool
+        {
+            return true;
+        }
+
+        auto potential_new_best(
+                const std::vector<unsigned> & c,
+                const std::vector<int> & position) -> void
+        {
+            std::vector<int> members;
+            for (auto & v : c)
+                members.push_back(order[v]);
+            ego.found(members, position);
+        }
+
+        auto get_best_anywhere_value() -> unsigned
+        {
+            // ego.v is in everything, but not in c
+            unsigned best = ego.best_anywhere.get();
+            return 0 == best ? 0 : best - 1;
+        }
+
+        auto get_local_result() -> MaxCliqueResult &
+        {
+            return ego.local_result;
+        }
+
+        auto get_skip_and_stop(unsigned, int &, int &, bool &) -> void
+        {
+        }
+
+        auto claim(unsigned, int) -> bool
+        {
+            return true;
+        }
+    };
+}
+
+template <CCOPermutations perm_>
+auto parasols::dcco_max_clique(const SparseGraph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    auto start_time = steady_clock::now();
+
+    int n = graph.size();
+
+    // degeneracy order: repeatedly remove a vertex of minimum degree
+    std::vector<int> order, position(n);
+    order.reserve(n);
+    {
+        DegreeBucketQueue<int> queue(n);
+        for (int v = 0 ; v < n ; ++v)
+            queue.insert(v, graph.degree(v), v);
+
+        for (int v ; -1 != (v = queue.pop_lowest()) ; ) {
+            position[v] = order.size();
+            order.push_back(v);
+
+            graph.for_each_neighbour(v, [&] (int w) {
+                    if (queue.contains(w))
+                        queue.decrement_degree(w);
+                    });
+        }
+    }
+
+    // the neighbours of each vertex which come after it, by position
+    std::vector<std::size_t> later_offsets(n + 1, 0);
+    std::vector<int> later;
+    for (int i = 0 ; i < n ; ++i) {
+        graph.for_each_neighbour(order[i], [&] (int w) {
+                if (position[w] > i)
+                    later.push_back(w);
+                });
+        later_offsets[i + 1] = later.size();
+    }
+
+    MaxCliqueResult result;
+    result.size = params.initial_bound;
+    result.times.push_back(duration_cast<milliseconds>(steady_clock::now() - start_time));
+
+    AtomicIncumbent best_anywhere;
+    best_anywhere.update(params.initial_bound);
+
+    // threads take vertices from the end of the order, where the dense
+    // bits are, so we find a good incumbent quickly
+    std::atomic<int> next{ 0 };
+    std::mutex result_mutex;
+
+    auto work = [&] () {
+        MaxCliqueResult local_result;
+
+        // the small graphs are solved one per thread, and ego.v is in
+        // everything they find
+        MaxCliqueParams ego_params = params;
+        ego_params.n_threads = 1;
+        ego_params.initial_bound = 0;
+        ego_params.vertex_transitive = false;
+        ego_params.break_symmetries = false;
+        if (0 != params.stop_after_finding)
+            ego_params.stop_after_finding = params.stop_after_finding - 1;
+
+        Ego ego{ params, best_anywhere, local_result, -1, { } };
+        std::vector<int> mark(n, -1);
+
+        while (true) {
+            int i = n - 1 - next.fetch_add(1);
+            if (i < 0 || params.abort->load() || best_anywhere.get() >= params.stop_after_finding)
+                break;
+
+            // can't beat the incumbent, even if all of them are adjacent?
+            unsigned n_later = later_offsets[i + 1] - later_offsets[i];
+            if (n_later + 1 <= best_anywhere.get())
+                continue;
+
+            ego.v = order[i];
+            ego.vertices.assign(later.begin() + later_offsets[i], later.begin() + later_offsets[i + 1]);
+
+            if (ego.vertices.empty()) {
+                ego.found(std::vector<int>{ }, std::vector<int>{ ego.v });
+                continue;
+            }
+
+            // build the small graph, looking only at edges going forwards
+            for (unsigned j = 0 ; j < n_later ; ++j)
+                mark[ego.vertices[j]] = j;
+
+            Graph ego_graph(n_later, false);
+            for (unsigned j = 0 ; j < n_later ; ++j) {
+                int u = position[ego.vertices[j]];
+                for (auto w = later.begin() + later_offsets[u], w_end = later.begin() + later_offsets[u + 1] ; w != w_end ; ++w)
+                    if (-1 != mark[*w])
+                        ego_graph.add_edge(j, mark[*w]);
+            }
+
+            for (auto & w : ego.vertices)
+                mark[w] = -1;
+
+            select_graph_size<ApplyPerm<EgoCCO, perm_>::template Type, void>(
+                    AllGraphSizesAndDynamic(), ego_graph, ego_params, ego);
+        }
+
+        std::unique_lock<std::mutex> guard(result_mutex);
+        result.merge(local_result);
+        result.times.push_back(duration_cast<milliseconds>(steady_clock::now() - start_time));
+    };
+
+    std::list<std::thread> threads;
+    for (unsigned t = 1 ; t < params.n_threads ; ++t)
+        threads.push_back(std::thread(work));
+
+    work();
+
+    for (auto & t : threads)
+        t.join();
+
+    return result;
+}
+
+template auto parasols::dcco_max_clique<CCOPermutations::None>(const SparseGraph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::dcco_max_clique<CCOPermutations::Defer1>(const SparseGraph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
@@ -0,0 +1,29 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_DCCO_MAX_CLIQUE_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_DCCO_MAX_CLIQUE_HH 1
+
+#include <graph/sparse_graph.hh>
+#include <cco/cco.hh>
+#include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
+
+namespace parasols
+{
+    /**
+     * Max clique algorithm for big sparse graphs, threaded.
+     *
+     * We put the vertices in degeneracy order, and then every clique is v
+     * plus a clique in the neighbours of v which come after it. So for each
+     * vertex, we make a small Graph out of its later neighbours, and solve
+     * that using the usual CCO search, with threads taking vertices in turn
+     * and sharing an incumbent. A vertex with too few later neighbours to
+     * beat the incumbent is skipped without building anything. No subproblem
+     * has more vertices than the degeneracy of the graph, so this works on
+     * graphs with millions of vertices.
+     */
+    template <CCOPermutations>
+    auto dcco_max_clique(const SparseGraph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+}
+
+#endif
@@ -0,0 +1,205 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/local_search.hh>
+#include <max_clique/print_incumbent.hh>
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace parasols;
+
+using std::chrono::steady_clock;
+
+namespace
+{
+    /**
+     * Penalties are all reduced by one after this many rounds of increases.
+     */
+    const constexpr int penalty_delay = 2;
+
+    /**
+     * How many swaps in a row, with no growth, before we say we're stuck.
+     */
+    const constexpr int plateau_limit = 100;
+
+    /**
+     * How many steps between looking at the clock.
+     */
+    const constexpr int steps_between_checks = 256;
+
+    /**
+     * One thread's search.
+     */
+    struct Search
+    {
+        const Graph & graph;
+        std::mt19937 rand;
+
+        /// How many members of c each vertex isn't adjacent to.
+        std::vector<int> missing;
+
+        std::vector<int> penalties;
+        std::vector<bool> in_c;
+        std::vector<int> c;
+
+        Search(const Graph & g, unsigned seed) :
+            graph(g),
+            rand(seed),
+            missing(g.size(), 0),
+            penalties(g.size(), 0),
+            in_c(g.size(), false)
+        {
+        }
+
+        /**
+         * Call f with every vertex other than v which isn't adjacent to v.
+         */
+        template <typename F_>
+        auto for_each_non_neighbour(int v, F_ && f) -> void
+        {
+            const Graph::AdjacencyWord * row = graph.row(v);
+            for (int w = 0 ; w < graph.words_per_row() ; ++w) {
+                Graph::AdjacencyWord word = ~row[w];
+                if (w == graph.words_per_row() - 1 && 0 != graph.size() % Graph::bits_per_adjacency_word)
+                    word &= (Graph::AdjacencyWord{ 1 } << (graph.size() % Graph::bits_per_adjacency_word)) - 1;
+
+                for ( ; 0 != word ; word &= word - 1) {
+                    int u = w * Graph::bits_per_adjacency_word + __builtin_ctzll(word);
+                    if (u != v)
+                        f(u);
+                }
+            }
+        }
+
+        auto add(int v) -> void
+        {
+            in_c[v] = true;
+            c.push_back(v);
+            for_each_non_neighbour(v, [&] (int u) { ++missing[u]; });
+        }
+
+        auto remove(int v) -> void
+        {
+            in_c[v] = false;
+            c.erase(std::find(c.begin(), c.end(), v));
+            for_each_non_neighbour(v, [&] (int u) { --missing[u]; });
+        }
+
+        /**
+         * The vertex not in c with this many non-neighbours in c and the
+         * lowest penalty, breaking ties randomly, or -1.
+         */
+        auto select(int want_missing, int tabu) -> int
+        {
+            int best = -1, ties = 0;
+            for (int u = 0 ; u < graph.size() ; ++u)
+                if (missing[u] == want_missing && ! in_c[u] && u != tabu) {
+                    if (-1 == best || penalties[u] < penalties[best]) {
+                        best = u;
+                        ties = 1;
+                    }
+                    else if (penalties[u] == penalties[best] && 0 == std::uniform_int_distribution<int>(0, ties++)(rand))
+                        best = u;
+                }
+
+            return best;
+        }
+    };
+}
+
+auto parasols::local_search_max_clique(const Graph & graph, const MaxCliqueParams & params,
+        std::chrono::milliseconds budget, AtomicIncumbent & incumbent) -> std::vector<int>
+{
+    std::vector<int> best;
+    std::mutex best_mutex;
+
+    if (0 == graph.size() || budget.count() <= 0)
+        return best;
+
+    auto end_time = steady_clock::now() + budget;
+
+    // nothing can beat the largest degree, plus one
+    unsigned degree_bound = 0;
+    for (int v = 0 ; v < graph.size() ; ++v)
+        degree_bound = std::max<unsigned>(degree_bound, graph.degree(v) + 1);
+
+    auto work = [&] (unsigned seed) {
+        Search search(graph, seed);
+        std::uniform_int_distribution<int> random_vertex(0, graph.size() - 1);
+
+        search.add(random_vertex(search.rand));
+
+        int last_removed = -1, plateau = 0;
+        unsigned long long steps = 0, penalty_rounds = 0;
+
+        while (true) {
+            if (0 == ++steps % steps_between_checks) {
+                unsigned current = incumbent.get();
+                if (steady_clock::now() >= end_time || params.abort->load()
+                        || current >= params.stop_after_finding || current >= degree_bound)
+                    break;
+            }
+
+            int v = search.select(0, -1);
+            if (-1 != v) {
+                search.add(v);
+                plateau = 0;
+
+                if (incumbent.beaten_by(search.c.size()) && incumbent.update(search.c.size())) {
+                    std::unique_lock<std::mutex> guard(best_mutex);
+                    if (search.c.size() > best.size()) {
+                        best = search.c;
+                        print_incumbent(params, best.size());
+                    }
+                }
+            }
+            else if (plateau < plateau_limit && -1 != (v = search.select(1, last_removed))) {
+                // swap v in, for the one thing in c it isn't adjacent to
+                ++plateau;
+                last_removed = *std::find_if(search.c.begin(), search.c.end(),
+                        [&] (int u) { return ! graph.adjacent(u, v); });
+                search.remove(last_removed);
+                search.add(v);
+            }
+            else {
+                // stuck, so make it less attractive to get here again...
+                for (auto & u : search.c)
+                    ++search.penalties[u];
+                if (0 == ++penalty_rounds % penalty_delay)
+                    for (auto & p : search.penalties)
+                        p = std::max(0, p - 1);
+
+                // ... and restart from a random vertex, keeping whatever
+                // is adjacent to it
+                do {
+                    v = random_vertex(search.rand);
+                } while (search.in_c[v] && search.c.size() < unsigned(graph.size()));
+
+                auto old_c = search.c;
+                for (auto & u : old_c)
+                    if (u != v && ! graph.adjacent(u, v))
+                        search.remove(u);
+                if (! search.in_c[v])
+                    search.add(v);
+
+                last_removed = -1;
+                plateau = 0;
+            }
+        }
+    };
+
+    std::list<std::thread> threads;
+    for (unsigned t = 1 ; t < params.n_threads ; ++t)
+        threads.push_back(std::thread(work, t));
+
+    work(0);
+
+    for (auto & t : threads)
+        t.join();
+
+    return best;
+}
+
@@ -0,0 +1,35 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_LOCAL_SEARCH_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_LOCAL_SEARCH_HH 1
+
+#include <graph/graph.hh>
+#include <max_clique/max_clique_params.hh>
+#include <threads/atomic_incumbent.hh>
+
+#include <chrono>
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * Look for a big clique using local search, in the style of DLS-MC,
+     * for at most budget (or until params.abort or
+     * params.stop_after_finding). Each of params.n_threads threads runs its
+     * own search, with its own random seed.
+     *
+     * A search grows a clique, preferring vertices with low penalties, and
+     * swaps a vertex in for its only non-neighbour in the clique when it
+     * can't grow any further. When it gets stuck, it penalises everything in
+     * the clique, and then restarts from a random vertex which keeps only its
+     * neighbours in the current clique.
+     *
+     * Improvements are published to incumbent as soon as they are found, so
+     * something else can share it. Returns the best clique found, or an
+     * empty vector if nothing beat what incumbent already had.
+     */
+    auto local_search_max_clique(const Graph & graph, const MaxCliqueParams & params,
+            std::chrono::milliseconds budget, AtomicIncumbent & incumbent) -> std::vector<int>;
+}
+
+#endif
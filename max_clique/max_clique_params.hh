@@ -10,14 +10,22 @@
 #include <atomic>
 #include <vector>
 #include <functional>
+#include <string>
 
 namespace parasols
 {
+    struct MaxCliqueCheckpoint;
+
     /**
      * Initial vertex ordering to use.
      */
     using MaxCliqueOrderFunction = std::function<void (const Graph &, std::vector<int> &)>;
 
+    /**
+     * Something to hand every clique to, when enumerating.
+     */
+    using MaxCliqueEnumerateCallback = std::function<void (const std::vector<int> &)>;
+
     /**
      * Parameters for a max clique algorithm.
      *
@@ -33,9 +41,24 @@ namespace parasols
         /// Exit immediately after finding a clique of this size.
         unsigned stop_after_finding = std::numeric_limits<unsigned>::max();
 
-        /// Enumerate solutions (only works with initial_bound).
+        /// Exit once the incumbent is within this many vertices of the
+        /// upper bound, where the algorithm keeps one.
+        unsigned stop_at_gap = 0;
+
+        /// Exit once the incumbent is at least this fraction of the upper
+        /// bound, where the algorithm keeps one.
+        double stop_at_ratio = 1.0;
+
+        /// Enumerate solutions, i.e. count every clique bigger than
+        /// initial_bound. Set initial_bound to omega - 1 to get every
+        /// maximum clique.
         bool enumerate = false;
 
+        /// If set, when enumerating, called with the members of every clique
+        /// counted, as soon as it is found. Threaded algorithms may call this
+        /// from several threads at once, so it must do its own locking.
+        MaxCliqueEnumerateCallback enumerate_callback;
+
         /// Indicates that the complement has been taken, for independent set
         /// (handled by the runner).
         bool complement = false;
@@ -63,6 +86,14 @@ namespace parasols
         /// If true, the graph is known to be vertex transitive.
         bool vertex_transitive = false;
 
+        /// If true, look for orbits of the automorphism group, and only
+        /// branch on the first vertex of each at the top of the search.
+        bool break_symmetries = true;
+
+        /// If true, once a cco or tcco subproblem has few enough vertices
+        /// left, solve it using a bit graph containing only those.
+        bool shrink_subproblems = true;
+
         /// If this is set to true, we should abort due to a time limit.
         std::atomic<bool> * abort;
 
@@ -74,6 +105,27 @@ namespace parasols
 
         /// Initial vertex ordering.
         MaxCliqueOrderFunction order_function;
+
+        /// If not empty, save a checkpoint here every checkpoint_interval,
+        /// and once more at the end (so a timeout doesn't lose anything).
+        /// Only the cco and tcco families do this.
+        std::string checkpoint_file;
+
+        /// How often to save a checkpoint.
+        std::chrono::seconds checkpoint_interval{ 600 };
+
+        /// If not zero, print roughly how much of the search has been done,
+        /// how fast it is going, and how long the rest should take, this
+        /// often. Only the cco and tcco families do this.
+        std::chrono::seconds progress_interval{ 0 };
+
+        /// What we're solving, saved with a checkpoint so that we don't
+        /// resume something else (handled by the runner).
+        std::string checkpoint_key;
+
+        /// If set, carry on from this checkpoint, which must have been made
+        /// by the same algorithm on the same graph.
+        const MaxCliqueCheckpoint * resume = nullptr;
     };
 }
 
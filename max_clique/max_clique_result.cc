@@ -8,6 +8,9 @@ auto MaxCliqueResult::merge(const MaxCliqueResult & other) -> void
 {
     nodes += other.nodes;
     donations += other.donations;
+    inference_attempts += other.inference_attempts;
+    inference_prunes += other.inference_prunes;
+    inference_time += other.inference_time;
     result_count += other.result_count;
     result_club_count += other.result_club_count;
     if (other.size > size) {
@@ -32,9 +32,29 @@ namespace parasols
         /// The initial colour bound. Not set by every algorithm.
         unsigned initial_colour_bound = 0;
 
+        /// Nothing bigger than this exists. Equal to size unless the search
+        /// stopped early, and not set by every algorithm.
+        unsigned upper_bound = 0;
+
+        /// Roughly what fraction of the search had been done, and how much
+        /// longer the rest would take (milliseconds::max() if we can't
+        /// tell), if we stopped early. Not set by every algorithm.
+        double estimated_fraction_done = 0.0;
+        std::chrono::milliseconds estimated_time_left{ 0 };
+
+        /// How many vertices an inference bound was tried on, if we have one.
+        unsigned long long inference_attempts = 0;
+
+        /// How many of those the inference bound threw away.
+        unsigned long long inference_prunes = 0;
+
+        /// Time spent in the inference bound, summed over threads.
+        std::chrono::steady_clock::duration inference_time{ 0 };
+
         /**
          * Runtimes. The first entry in the list is the total runtime.
-         * Additional values are for each worker thread.
+         * Algorithms which re-encode the graph as a bit graph then say how
+         * long that took. Additional values are for each worker thread.
          */
         std::list<std::chrono::milliseconds> times;
 
@@ -44,7 +64,7 @@ namespace parasols
         auto merge(const MaxCliqueResult &) -> void;
 
         /// A count, if enumerating.
-        unsigned result_count = 0;
+        unsigned long long result_count = 0;
 
         /// A count of clubs, if enumerating and checking clubs.
         unsigned result_club_count = 0;
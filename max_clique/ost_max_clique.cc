@@ -3,6 +3,7 @@
 #include <max_clique/ost_max_clique.hh>
 #include <max_clique/print_incumbent.hh>
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
 #include <graph/template_voodoo.hh>
 #include <numeric>
 
@@ -18,6 +19,7 @@ namespace
         const MaxCliqueParams & params;
         std::vector<int> order;
         std::vector<int> subproblems;
+        std::chrono::milliseconds encode_time;
 
         OST(const Graph & g, const MaxCliqueParams & p) :
             params(p),
@@ -29,12 +31,7 @@ namespace
             params.order_function(g, order);
 
             // re-encode graph as a bit graph
-            graph.resize(g.size());
-
-            for (int i = 0 ; i < g.size() ; ++i)
-                for (int j = 0 ; j < g.size() ; ++j)
-                    if (g.adjacent(order[i], order[j]))
-                        graph.add_edge(i, j);
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
         }
 
         auto expand(
@@ -61,9 +58,7 @@ namespace
 
                 // filter p to contain vertices adjacent to v
                 FixedBitSet<size_> new_p = p;
-                graph.intersect_with_row(v, new_p);
-
-                if (new_p.empty()) {
+                if (graph.intersect_with_row_and_test_empty(v, new_p)) {
                     if (c.size() > result.size) {
                         result.size = c.size();
 
@@ -94,6 +89,7 @@ namespace
         auto run() -> MaxCliqueResult
         {
             result.size = params.initial_bound;
+            result.times.push_back(encode_time);
 
             subproblems[graph.size() - 1] = 1;
 
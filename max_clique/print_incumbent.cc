@@ -3,6 +3,7 @@
 #include <max_clique/print_incumbent.hh>
 #include <threads/output_lock.hh>
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 
@@ -64,6 +65,38 @@ auto parasols::print_incumbent(
     }
 }
 
+auto parasols::print_upper_bound(const MaxCliqueParams & params, unsigned bound) -> void
+{
+    if (params.print_incumbents)
+        std::cout
+            << lock_output()
+            << "-- " << duration_cast<milliseconds>(steady_clock::now() - params.start_time).count()
+            << " bound " << bound << std::endl;
+}
+
+auto parasols::print_progress(
+        const MaxCliqueParams & params,
+        double fraction,
+        unsigned long long nodes,
+        double nodes_per_second,
+        milliseconds time_left) -> void
+{
+    if (0 != params.progress_interval.count()) {
+        std::stringstream w;
+        w << std::fixed << std::setprecision(2) << fraction * 100.0 << "% nodes " << nodes
+            << " rate " << std::setprecision(0) << nodes_per_second << "/s eta ";
+        if (milliseconds::max() == time_left)
+            w << "unknown";
+        else
+            w << time_left.count() / 1000 << "s";
+
+        std::cout
+            << lock_output()
+            << "-- " << duration_cast<milliseconds>(steady_clock::now() - params.start_time).count()
+            << " progress " << w.str() << std::endl;
+    }
+}
+
 auto parasols::print_position(
         const MaxCliqueParams & params,
         const std::string & message,
@@ -5,6 +5,7 @@
 
 #include <graph/graph.hh>
 #include <max_clique/max_clique_params.hh>
+#include <chrono>
 #include <vector>
 #include <set>
 
@@ -32,6 +33,20 @@ namespace parasols
             const std::vector<int> & positions,
             bool is_club) -> void;
 
+    /**
+     * Do some output for a new upper bound, if params.print_incumbents is
+     * true.
+     */
+    auto print_upper_bound(const MaxCliqueParams & params, unsigned bound) -> void;
+
+    /**
+     * Do some output for an estimate of how far the search has got, if
+     * params.progress_interval is set. time_left is milliseconds::max() if
+     * we can't tell yet.
+     */
+    auto print_progress(const MaxCliqueParams & params, double fraction, unsigned long long nodes,
+            double nodes_per_second, std::chrono::milliseconds time_left) -> void;
+
     /**
      * Do some generic string output for a position, if params.print_incumbents is true.
      */
@@ -0,0 +1,292 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/progress.hh>
+#include <max_clique/print_incumbent.hh>
+
+#include <threads/output_lock.hh>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace parasols;
+
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+MaxCliqueProgress::~MaxCliqueProgress()
+{
+    if (_ticker.joinable()) {
+        {
+            std::unique_lock<std::mutex> guard(_ticker_mutex);
+            _finishing = true;
+            _ticker_cv.notify_all();
+        }
+        _ticker.join();
+    }
+}
+
+auto MaxCliqueProgress::start(const MaxCliqueParams & params, const std::vector<int> & order,
+        std::vector<unsigned> && colour_of, unsigned n_threads, MaxCliqueResult & result) -> void
+{
+    _params = &params;
+    _order = &order;
+    _started = true;
+
+    _n_slots = n_threads;
+    _slots.reset(new Slot[n_threads]);
+    _done.reset(new std::atomic<bool>[order.size()]);
+    _partly_done.reset(new std::atomic<float>[order.size()]);
+    _resumed.assign(order.size(), false);
+
+    if (params.resume) {
+        std::vector<int> position_of(order.size());
+        for (unsigned i = 0 ; i < order.size() ; ++i)
+            position_of[order[i]] = i;
+
+        for (auto & v : params.resume->done)
+            _resumed[position_of[v]] = true;
+
+        _resumed_nodes = params.resume->nodes;
+
+        if (params.resume->members.size() > result.size) {
+            result.size = params.resume->members.size();
+            result.members = params.resume->members;
+        }
+    }
+
+    for (unsigned v = 0 ; v < order.size() ; ++v) {
+        _done[v].store(_resumed[v]);
+        _partly_done[v].store(0.0);
+    }
+
+    _members = result.members;
+    _incumbent_size.store(result.size);
+
+    // when enumerating, the bound isn't what we're interested in
+    _colour_of = std::move(colour_of);
+
+    _bounding = ! params.enumerate && ! order.empty();
+    if (_bounding) {
+        int first = std::max_element(_colour_of.begin(), _colour_of.end()) - _colour_of.begin();
+        _slots[0].working_on.store(first);
+        _upper_bound.store(std::max(result.size, _colour_of[first]));
+        print_upper_bound(params, _upper_bound.load());
+    }
+
+    // time left is worked out from how fast we're going this time
+    _start_time = steady_clock::now();
+    _resumed_fraction = order.empty() ? 0.0 : estimate();
+
+    bool saving = ! params.checkpoint_file.empty(), reporting = 0 != params.progress_interval.count();
+    if (saving || reporting)
+        _ticker = std::thread([this, saving, reporting] {
+                auto next_save = _start_time + _params->checkpoint_interval;
+                auto next_report = _start_time + _params->progress_interval;
+
+                std::unique_lock<std::mutex> guard(_ticker_mutex);
+                while (! _finishing) {
+                    auto next = ! saving ? next_report : ! reporting ? next_save : std::min(next_save, next_report);
+                    if (std::cv_status::timeout == _ticker_cv.wait_until(guard, next)) {
+                        if (saving && steady_clock::now() >= next_save) {
+                            // carry on searching if we can't save, and try again later
+                            try {
+                                save();
+                            }
+                            catch (const CheckpointFileError & e) {
+                                std::cerr << lock_output() << e.what() << std::endl;
+                            }
+                            next_save = steady_clock::now() + _params->checkpoint_interval;
+                        }
+
+                        if (reporting && steady_clock::now() >= next_report) {
+                            report();
+                            next_report += _params->progress_interval;
+                        }
+                    }
+                }
+                });
+}
+
+auto MaxCliqueProgress::stop(MaxCliqueResult & result) -> void
+{
+    if (! _started)
+        return;
+
+    result.nodes += _resumed_nodes;
+
+    // if we didn't stop early, we've shown there's nothing better. If we
+    // stopped because we found something big enough, threads might have
+    // given up on their branches before we heard about it, so we don't know.
+    if (_bounding && result.size < _params->stop_after_finding) {
+        if (_params->abort->load())
+            result.upper_bound = std::max(result.size, _upper_bound.load());
+        else
+            result.upper_bound = result.size;
+    }
+
+    if (_params->abort->load() && ! _order->empty()) {
+        result.estimated_fraction_done = estimate();
+        result.estimated_time_left = time_left(result.estimated_fraction_done);
+    }
+
+    if (_ticker.joinable()) {
+        {
+            std::unique_lock<std::mutex> guard(_ticker_mutex);
+            _finishing = true;
+            _ticker_cv.notify_all();
+        }
+        _ticker.join();
+        if (! _params->checkpoint_file.empty())
+            save();
+    }
+
+    _started = false;
+}
+
+auto MaxCliqueProgress::snapshot(MaxCliqueCheckpoint & checkpoint) -> bool
+{
+    std::vector<unsigned> steal_counts(_n_slots);
+    for (unsigned t = 0 ; t < _n_slots ; ++t) {
+        steal_counts[t] = _slots[t].steal_count.load();
+        if (steal_counts[t] % 2)
+            return false;
+    }
+
+    std::vector<bool> done(_order->size());
+    for (unsigned v = 0 ; v < _order->size() ; ++v)
+        done[v] = _done[v].load();
+
+    // anything someone is still working under isn't finished yet
+    unsigned long long nodes = _resumed_nodes;
+    for (unsigned t = 0 ; t < _n_slots ; ++t) {
+        int v = _slots[t].working_on.load();
+        if (-1 != v)
+            done[v] = false;
+        nodes += _slots[t].nodes.load();
+    }
+
+    for (unsigned t = 0 ; t < _n_slots ; ++t)
+        if (steal_counts[t] != _slots[t].steal_count.load())
+            return false;
+
+    checkpoint.key = _params->checkpoint_key;
+    checkpoint.nodes = nodes;
+    for (unsigned v = 0 ; v < _order->size() ; ++v)
+        if (done[v])
+            checkpoint.done.insert((*_order)[v]);
+
+    {
+        std::unique_lock<std::mutex> guard(_incumbent_mutex);
+        checkpoint.members = _members;
+    }
+
+    return true;
+}
+
+auto MaxCliqueProgress::save() -> void
+{
+    MaxCliqueCheckpoint checkpoint;
+    while (! snapshot(checkpoint))
+        std::this_thread::yield();
+
+    write_max_clique_checkpoint(_params->checkpoint_file, checkpoint);
+    print_position(*_params, "checkpointed " + std::to_string(checkpoint.done.size()) + " done", std::vector<int>{ });
+}
+
+auto MaxCliqueProgress::estimate() const -> double
+{
+    unsigned incumbent = _incumbent_size.load();
+
+    double done = 0.0, all = 0.0;
+    for (unsigned v = 0 ; v < _order->size() ; ++v) {
+        double w = weight(_colour_of[v], incumbent);
+        all += w;
+        done += w * (_done[v].load() ? 1.0 : _partly_done[v].load(std::memory_order_relaxed));
+    }
+
+    // if nothing is left which could beat the incumbent, we're finished
+    return 0.0 == all ? 1.0 : std::min(1.0, done / all);
+}
+
+auto MaxCliqueProgress::time_left(double fraction) const -> milliseconds
+{
+    // we can only guess once we've done something ourselves
+    if (fraction <= _resumed_fraction)
+        return milliseconds::max();
+
+    auto elapsed = duration_cast<milliseconds>(steady_clock::now() - _start_time);
+    return milliseconds(static_cast<long long>(elapsed.count() * (1.0 - fraction) / (fraction - _resumed_fraction)));
+}
+
+auto MaxCliqueProgress::report() -> void
+{
+    unsigned long long nodes = 0;
+    for (unsigned t = 0 ; t < _n_slots ; ++t)
+        nodes += _slots[t].nodes.load(std::memory_order_relaxed);
+
+    double seconds = duration<double>(steady_clock::now() - _start_time).count();
+    double fraction = _order->empty() ? 1.0 : estimate();
+    print_progress(*_params, fraction, _resumed_nodes + nodes, seconds > 0.0 ? nodes / seconds : 0.0, time_left(fraction));
+}
+
+auto MaxCliqueProgress::update_upper_bound() -> void
+{
+    // once we've been told to stop, threads leave their branches unfinished
+    if (! _bounding || _params->abort->load())
+        return;
+
+    std::vector<unsigned> steal_counts(_n_slots);
+    for (unsigned t = 0 ; t < _n_slots ; ++t) {
+        steal_counts[t] = _slots[t].steal_count.load();
+        if (steal_counts[t] % 2)
+            return;
+    }
+
+    unsigned incumbent = _incumbent_size.load();
+    unsigned bound = incumbent;
+    for (unsigned t = 0 ; t < _n_slots ; ++t) {
+        int v = _slots[t].working_on.load();
+        if (-1 != v)
+            bound = std::max(bound, _colour_of[v]);
+    }
+
+    // if someone was stealing, we might have missed what they took, so
+    // we'll have to wait until next time
+    for (unsigned t = 0 ; t < _n_slots ; ++t)
+        if (steal_counts[t] != _slots[t].steal_count.load())
+            return;
+
+    unsigned current = _upper_bound.load();
+    while (bound < current)
+        if (_upper_bound.compare_exchange_weak(current, bound)) {
+            print_upper_bound(*_params, bound);
+            current = bound;
+            break;
+        }
+
+    if ((0 != _params->stop_at_gap || _params->stop_at_ratio < 1.0)
+            && (current <= incumbent + _params->stop_at_gap || incumbent >= _params->stop_at_ratio * current)) {
+        print_position(*_params, "stopping with " + std::to_string(incumbent) + " of at most " + std::to_string(current),
+                std::vector<int>{ });
+        _params->abort->store(true);
+    }
+}
+
+auto MaxCliqueProgress::new_incumbent(const std::set<int> & members) -> void
+{
+    if (! _started || members.size() <= _incumbent_size.load())
+        return;
+
+    {
+        std::unique_lock<std::mutex> guard(_incumbent_mutex);
+        if (members.size() > _members.size()) {
+            _members = members;
+            if (_members.size() > _incumbent_size.load())
+                _incumbent_size.store(_members.size());
+        }
+    }
+
+    update_upper_bound();
+}
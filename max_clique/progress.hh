@@ -0,0 +1,237 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_PROGRESS_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_PROGRESS_HH 1
+
+#include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
+#include <max_clique/checkpoint.hh>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * Keeps track of how far the top level of a CCO search has got. This
+     * gives an upper bound which goes down as top level branches finish,
+     * which stops the search if params.stop_at_gap or stop_at_ratio says
+     * the incumbent is good enough. If params asks for checkpoints, which
+     * top level branches have been finished is saved every
+     * params.checkpoint_interval, and once more at the end, and when
+     * resuming, this says which top level branches to skip. If params asks
+     * for progress reports, we print an estimate of how much has been done
+     * every params.progress_interval.
+     *
+     * This does nothing until start() is called, so algorithms which don't
+     * know about it can ignore it. Vertices are those of the bit graph, and
+     * order maps them back for the file.
+     *
+     * With several threads, a branch can be finished by its owner while
+     * parts of it stolen by others are still going, so each thread says
+     * which top level branch it is working under. Thieves don't know this
+     * until they have stolen something, so stealing() and stolen() bracket
+     * that, and a snapshot is only used if no-one was part way through.
+     *
+     * The top level is coloured once, and branches are taken in decreasing
+     * colour order, so the owner of the top level starts off under the
+     * first branch, and everything it hasn't got to yet has no bigger a
+     * colour than the branch it is on. Anything stolen from the top level
+     * comes after that too. So the biggest colour of anything a thread is
+     * working under, or the incumbent, whichever is bigger, is a bound.
+     *
+     * To estimate how much has been done, each top level branch is given a
+     * weight (see weight()), and a branch which is under way gets credit
+     * for how far its owner has got through the second level, weighting
+     * the branches there in the same way. This is only a rough guide, but
+     * it is cheap, and it does get to 1 as the search finishes.
+     */
+    class MaxCliqueProgress
+    {
+        private:
+            struct Slot
+            {
+                std::atomic<unsigned> steal_count{ 0 };
+                std::atomic<int> working_on{ -1 };
+                std::atomic<unsigned long long> nodes{ 0 };
+            };
+
+            const MaxCliqueParams * _params = nullptr;
+            const std::vector<int> * _order = nullptr;
+            bool _started = false;
+
+            std::vector<bool> _resumed;
+            std::unique_ptr<std::atomic<bool>[]> _done;
+            std::unique_ptr<std::atomic<float>[]> _partly_done;
+            std::unique_ptr<Slot[]> _slots;
+            unsigned _n_slots = 0;
+            unsigned long long _resumed_nodes = 0;
+            double _resumed_fraction = 0.0;
+            std::chrono::steady_clock::time_point _start_time;
+
+            std::mutex _incumbent_mutex;
+            std::set<int> _members;
+            std::atomic<unsigned> _incumbent_size{ 0 };
+
+            bool _bounding = false;
+            std::vector<unsigned> _colour_of;
+            std::atomic<unsigned> _upper_bound{ 0 };
+
+            std::thread _ticker;
+            std::mutex _ticker_mutex;
+            std::condition_variable _ticker_cv;
+            bool _finishing = false;
+
+            auto snapshot(MaxCliqueCheckpoint &) -> bool;
+            auto save() -> void;
+            auto update_upper_bound() -> void;
+            auto estimate() const -> double;
+            auto time_left(double fraction) const -> std::chrono::milliseconds;
+            auto report() -> void;
+
+        public:
+            MaxCliqueProgress() = default;
+            ~MaxCliqueProgress();
+
+            MaxCliqueProgress(const MaxCliqueProgress &) = delete;
+            MaxCliqueProgress & operator= (const MaxCliqueProgress &) = delete;
+
+            /**
+             * Start keeping track, for n_threads threads, where thread 0
+             * owns the top level. colour_of gives the colour of each vertex
+             * in the top level colouring. If resuming, result gets the
+             * incumbent from the checkpoint. Node counts given to us are
+             * for this run only.
+             */
+            auto start(const MaxCliqueParams & params, const std::vector<int> & order,
+                    std::vector<unsigned> && colour_of, unsigned n_threads, MaxCliqueResult & result) -> void;
+
+            /**
+             * Stop, saving a final checkpoint, and add in the nodes from
+             * before we resumed, the upper bound, and if we stopped early,
+             * how far we think we got.
+             */
+            auto stop(MaxCliqueResult & result) -> void;
+
+            /**
+             * How much a branch counts for when estimating how much has been
+             * done, if its colour bound (including what's already in c) is
+             * bound. The time taken to search a branch goes up roughly as a
+             * power of how far its bound is above the incumbent, and the
+             * fourth power fits random graphs reasonably well. Branches
+             * whose bound is no bigger than the incumbent count for nothing.
+             */
+            static auto weight(unsigned bound, unsigned incumbent) -> double
+            {
+                double gap = bound > incumbent ? bound - incumbent : 0;
+                return gap * gap * gap * gap;
+            }
+
+            /**
+             * Has start() been called? Lets callers skip working out things
+             * we'd only ignore.
+             */
+            auto started() const -> bool
+            {
+                return _started;
+            }
+
+            /**
+             * Was the top level branch on v finished before we resumed?
+             */
+            auto resumed(int v) const -> bool
+            {
+                return _started && _resumed[v];
+            }
+
+            /**
+             * This thread is now working under the top level branch on v.
+             */
+            auto starting(unsigned thread, int v) -> void
+            {
+                if (_started) {
+                    _slots[thread].working_on.store(v);
+                    update_upper_bound();
+                }
+            }
+
+            /**
+             * This thread has finished the top level branch on v (apart from
+             * anything stolen from it, which others will say they're doing).
+             */
+            auto finished(unsigned thread, int v, unsigned long long nodes) -> void
+            {
+                if (_started) {
+                    _slots[thread].nodes.store(nodes);
+                    _done[v].store(true);
+                }
+            }
+
+            /**
+             * About this fraction of the top level branch on v has been
+             * done. Only the thread which owns that branch says this, and
+             * branches which were skipped without being searched count as
+             * wholly done.
+             */
+            auto partly_done(int v, double fraction) -> void
+            {
+                if (_started)
+                    _partly_done[v].store(fraction, std::memory_order_relaxed);
+            }
+
+            /**
+             * This thread has done this many nodes so far.
+             */
+            auto counted(unsigned thread, unsigned long long nodes) -> void
+            {
+                if (_started)
+                    _slots[thread].nodes.store(nodes, std::memory_order_relaxed);
+            }
+
+            /**
+             * This thread has finished everything it was given.
+             */
+            auto idle(unsigned thread, unsigned long long nodes) -> void
+            {
+                if (_started) {
+                    _slots[thread].nodes.store(nodes);
+                    _slots[thread].working_on.store(-1);
+                    update_upper_bound();
+                }
+            }
+
+            /**
+             * This thread is about to try to steal.
+             */
+            auto stealing(unsigned thread) -> void
+            {
+                if (_started)
+                    ++_slots[thread].steal_count;
+            }
+
+            /**
+             * This thread has finished trying to steal, and if it got
+             * something, that is under the top level branch on v.
+             */
+            auto stolen(unsigned thread, int v) -> void
+            {
+                if (_started) {
+                    _slots[thread].working_on.store(v);
+                    ++_slots[thread].steal_count;
+                }
+            }
+
+            /**
+             * We have a new incumbent.
+             */
+            auto new_incumbent(const std::set<int> & members) -> void;
+    };
+}
+
+#endif
@@ -0,0 +1,210 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/reduce_graph.hh>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace parasols;
+
+namespace
+{
+    using Word = Graph::AdjacencyWord;
+
+    /**
+     * How many vertices the greedy clique tries starting from. Plenty for
+     * the big sparse graphs this is aimed at, and on dense graphs there is
+     * nothing much to peel anyway.
+     */
+    const constexpr int greedy_clique_starts = 1000;
+
+    auto test_bit(const std::vector<Word> & bits, int v) -> bool
+    {
+        return bits[v / Graph::bits_per_adjacency_word] & (Word{ 1 } << (v % Graph::bits_per_adjacency_word));
+    }
+
+    auto unset_bit(std::vector<Word> & bits, int v) -> void
+    {
+        bits[v / Graph::bits_per_adjacency_word] &= ~(Word{ 1 } << (v % Graph::bits_per_adjacency_word));
+    }
+
+    /**
+     * Start from each of the highest degree vertices in turn, and keep
+     * adding whichever remaining candidate has the highest degree.
+     */
+    auto greedy_clique(const Graph & graph) -> std::vector<int>
+    {
+        std::vector<int> starts(graph.size());
+        std::iota(starts.begin(), starts.end(), 0);
+        std::stable_sort(starts.begin(), starts.end(),
+                [&] (int a, int b) { return graph.degree(a) > graph.degree(b); });
+        if (starts.size() > unsigned(greedy_clique_starts))
+            starts.resize(greedy_clique_starts);
+
+        std::vector<int> best, c;
+        std::vector<Word> candidates(graph.words_per_row());
+
+        for (auto & s : starts) {
+            // nothing from here on can do better
+            if (graph.degree(s) + 1 <= int(best.size()))
+                break;
+
+            c.assign(1, s);
+            std::copy(graph.row(s), graph.row(s) + graph.words_per_row(), candidates.begin());
+
+            while (true) {
+                int next = -1;
+                for (int w = 0 ; w < graph.words_per_row() ; ++w)
+                    for (Word word = candidates[w] ; 0 != word ; word &= word - 1) {
+                        int v = w * Graph::bits_per_adjacency_word + __builtin_ctzll(word);
+                        if (-1 == next || graph.degree(v) > graph.degree(next))
+                            next = v;
+                    }
+
+                if (-1 == next)
+                    break;
+
+                c.push_back(next);
+                const Word * row = graph.row(next);
+                for (int w = 0 ; w < graph.words_per_row() ; ++w)
+                    candidates[w] &= row[w];
+            }
+
+            if (c.size() > best.size())
+                best = c;
+        }
+
+        return best;
+    }
+
+    /**
+     * Greedily colour the remaining neighbours of v, giving up once we've
+     * used limit colours. Returns how many colours we used.
+     */
+    auto colour_neighbourhood(const Graph & graph, const std::vector<Word> & alive, int v, unsigned limit,
+            std::vector<Word> & p, std::vector<Word> & q) -> unsigned
+    {
+        const Word * row = graph.row(v);
+
+        // only look at the words where v has neighbours
+        int first = graph.words_per_row(), last = 0;
+        for (int w = 0 ; w < graph.words_per_row() ; ++w) {
+            p[w] = row[w] & alive[w];
+            if (0 != p[w]) {
+                first = std::min(first, w);
+                last = w + 1;
+            }
+        }
+
+        unsigned colours = 0;
+        while (colours < limit && first < last) {
+            ++colours;
+            std::copy(p.begin() + first, p.begin() + last, q.begin() + first);
+
+            for (int w = first ; w < last ; ++w)
+                while (0 != q[w]) {
+                    int u = w * Graph::bits_per_adjacency_word + __builtin_ctzll(q[w]);
+                    unset_bit(p, u);
+                    unset_bit(q, u);
+
+                    const Word * u_row = graph.row(u);
+                    for (int x = w ; x < last ; ++x)
+                        q[x] &= ~u_row[x];
+                }
+
+            while (first < last && 0 == p[first])
+                ++first;
+            while (first < last && 0 == p[last - 1])
+                --last;
+        }
+
+        return colours;
+    }
+}
+
+auto parasols::reduce_graph(const Graph & graph, unsigned initial_bound, bool greedy, bool colour) -> ReducedGraph
+{
+    ReducedGraph result;
+    result.bound = initial_bound;
+
+    if (greedy) {
+        auto clique = greedy_clique(graph);
+        if (clique.size() > result.bound) {
+            result.bound = clique.size();
+            result.clique = std::move(clique);
+        }
+    }
+
+    std::vector<Word> alive(graph.words_per_row(), 0);
+    std::vector<int> degrees(graph.size());
+    std::vector<int> doomed;
+    int removed = 0;
+
+    auto kill = [&] (int v) {
+        if (test_bit(alive, v)) {
+            unset_bit(alive, v);
+            doomed.push_back(v);
+            ++removed;
+        }
+    };
+
+    // a vertex with fewer than bound neighbours left can't be in a clique
+    // bigger than bound, and losing it might mean its neighbours go too
+    auto peel = [&] () {
+        while (! doomed.empty()) {
+            int v = doomed.back();
+            doomed.pop_back();
+            graph.for_each_neighbour(v, [&] (int w) {
+                    if (test_bit(alive, w) && --degrees[w] < int(result.bound))
+                        kill(w);
+                    });
+        }
+    };
+
+    for (int v = 0 ; v < graph.size() ; ++v)
+        alive[v / Graph::bits_per_adjacency_word] |= Word{ 1 } << (v % Graph::bits_per_adjacency_word);
+
+    for (int v = 0 ; v < graph.size() ; ++v) {
+        degrees[v] = graph.degree(v);
+        if (degrees[v] < int(result.bound))
+            kill(v);
+    }
+
+    peel();
+
+    // keep going until the colour bound can't remove anything else
+    if (colour && 0 != result.bound) {
+        std::vector<Word> p(graph.words_per_row()), q(graph.words_per_row());
+        for (bool changed = true ; changed ; ) {
+            changed = false;
+            for (int v = 0 ; v < graph.size() ; ++v)
+                if (test_bit(alive, v) && colour_neighbourhood(graph, alive, v, result.bound, p, q) < result.bound) {
+                    kill(v);
+                    peel();
+                    changed = true;
+                }
+        }
+    }
+
+    if (0 == removed) {
+        result.unchanged = true;
+        return result;
+    }
+
+    std::vector<int> position(graph.size(), -1);
+    for (int v = 0 ; v < graph.size() ; ++v)
+        if (test_bit(alive, v)) {
+            position[v] = result.vertices.size();
+            result.vertices.push_back(v);
+        }
+
+    result.graph = Graph(result.vertices.size(), graph.add_one_for_output());
+    for (unsigned i = 0 ; i < result.vertices.size() ; ++i)
+        graph.for_each_neighbour(result.vertices[i], [&] (int w) {
+                if (position[w] > int(i))
+                    result.graph.add_edge(i, position[w]);
+                });
+
+    return result;
+}
+
@@ -0,0 +1,50 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_REDUCE_GRAPH_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_REDUCE_GRAPH_HH 1
+
+#include <graph/graph.hh>
+
+#include <vector>
+
+namespace parasols
+{
+    /**
+     * What is left of a graph after reduce_graph.
+     */
+    struct ReducedGraph
+    {
+        /// The vertices which might still be in a clique bigger than bound.
+        Graph graph;
+
+        /// Vertex i of graph is vertex vertices[i] of the original graph.
+        std::vector<int> vertices;
+
+        /// The greedy clique, in original vertex numbers. Might be empty.
+        std::vector<int> clique;
+
+        /// Anything interesting has to be bigger than this.
+        unsigned bound = 0;
+
+        /// If nothing could be removed, graph and vertices are left empty,
+        /// and the original graph should be used as it is.
+        bool unchanged = false;
+    };
+
+    /**
+     * Throw away vertices which can't be in a clique bigger than the
+     * incumbent, so that the solver gets a smaller graph to encode.
+     *
+     * The incumbent is initial_bound, or if greedy is true, whatever a
+     * quick greedy clique gets if that is better. (Don't use greedy if
+     * enumerating, since we'd then miss cliques the same size as the greedy
+     * one.) A vertex in a clique bigger than the incumbent has at least
+     * incumbent neighbours in it, so we repeatedly peel off vertices of
+     * smaller degree. If colour is true, we also drop any vertex whose
+     * remaining neighbourhood can be greedily coloured with too few colours,
+     * and peel again after that.
+     */
+    auto reduce_graph(const Graph & graph, unsigned initial_bound, bool greedy, bool colour) -> ReducedGraph;
+}
+
+#endif
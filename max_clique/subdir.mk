@@ -4,10 +4,17 @@ SOURCES := \
 	cco_base.cc \
 	cco_max_clique.cc \
 	cco_inference.cc \
+	reduce_graph.cc \
+	local_search.cc \
+	dcco_max_clique.cc \
 	tcco_max_clique.cc \
 	ost_max_clique.cc \
+	tost_max_clique.cc \
+	bk_maximal_cliques.cc \
 	max_clique_params.cc \
 	max_clique_result.cc \
+	checkpoint.cc \
+	progress.cc \
 	naive_max_clique.cc \
 	print_incumbent.cc \
 	algorithms.cc
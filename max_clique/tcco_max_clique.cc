@@ -5,6 +5,7 @@
 #include <max_clique/print_incumbent.hh>
 
 #include <threads/queue.hh>
+#include <threads/work_stealing_deque.hh>
 #include <threads/atomic_incumbent.hh>
 
 #include <graph/template_voodoo.hh>
@@ -13,7 +14,7 @@
 #include <algorithm>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
+#include <atomic>
 
 using namespace parasols;
 
@@ -23,93 +24,12 @@ using std::chrono::milliseconds;
 
 namespace
 {
-    const constexpr int number_of_depths = 5;
-    const constexpr int number_of_steal_points = number_of_depths - 1;
-
     struct Subproblem
     {
         std::vector<int> offsets;
-    };
 
-    struct QueueItem
-    {
-        Subproblem subproblem;
-    };
-
-    struct StealPoint
-    {
-        std::mutex mutex;
-        std::condition_variable cv;
-
-        bool is_finished;
-
-        bool has_data;
-        std::vector<int> data;
-
-        bool was_stolen;
-
-        StealPoint() :
-            is_finished(false),
-            has_data(false),
-            was_stolen(false)
-        {
-            mutex.lock();
-        }
-
-        void publish(std::vector<int> & s)
-        {
-            if (is_finished)
-                return;
-
-            data = s;
-            has_data = true;
-            cv.notify_all();
-            mutex.unlock();
-        }
-
-        bool steal(std::vector<int> & s) __attribute__((noinline))
-        {
-            std::unique_lock<std::mutex> guard(mutex);
-
-            while ((! has_data) && (! is_finished))
-                cv.wait(guard);
-
-            if (! is_finished && has_data) {
-                s = data;
-                was_stolen = true;
-                return true;
-            }
-            else
-                return false;
-        }
-
-        bool unpublish_and_keep_going()
-        {
-            if (is_finished)
-                return true;
-
-            mutex.lock();
-            has_data = false;
-            return ! was_stolen;
-        }
-
-        void finished()
-        {
-            is_finished = true;
-            has_data = false;
-            cv.notify_all();
-            mutex.unlock();
-        }
-    };
-
-    struct alignas(16) StealPoints
-    {
-        std::vector<StealPoint> points;
-
-        StealPoints() :
-            points{ number_of_steal_points }
-        {
-        }
+        /// Which thread is solving this.
+        unsigned thread = 0;
     };
 
     template <typename Base_, bool merge_queue_, unsigned size_, typename VertexType_>
@@ -195,17 +115,21 @@ namespace
         }
     };
 
-    template <CCOPermutations perm_, CCOInference inference_, bool merge_queue_, unsigned size_, typename VertexType_>
-    struct TCCO : CCOBase<perm_, inference_, size_, VertexType_, TCCO<perm_, inference_, merge_queue_, size_, VertexType_> >
+    template <CCOPermutations perm_, CCOInference inference_, bool merge_queue_, bool inverse_, unsigned size_, typename VertexType_>
+    struct TCCO : CCOBase<perm_, inference_, size_, VertexType_, TCCO<perm_, inference_, merge_queue_, inverse_, size_, VertexType_>, inverse_>
     {
-        using Base = CCOBase<perm_, inference_, size_, VertexType_, TCCO<perm_, inference_, merge_queue_, size_, VertexType_> >;
+        using Base = CCOBase<perm_, inference_, size_, VertexType_, TCCO<perm_, inference_, merge_queue_, inverse_, size_, VertexType_>, inverse_>;
 
         using Base::graph;
         using Base::original_graph;
         using Base::params;
         using Base::expand;
         using Base::order;
+        using Base::encode_time;
         using Base::colour_class_order;
+        using Base::enumerate_found;
+        using Base::progress;
+        using Base::start_progress;
 
         AtomicIncumbent best_anywhere; // global incumbent
 
@@ -226,31 +150,34 @@ namespace
 
             MaxCliqueResult global_result;
             global_result.size = params.initial_bound;
+            global_result.times.push_back(encode_time);
             std::mutex global_result_mutex;
 
-            /* work queues */
-            std::vector<std::unique_ptr<Queue<QueueItem> > > queues;
-            for (unsigned depth = 0 ; depth < number_of_depths ; ++depth)
-                queues.push_back(std::unique_ptr<Queue<QueueItem> >{ new Queue<QueueItem>{ params.n_threads, false } });
-
-            /* initial job */
-            queues[0]->enqueue(QueueItem{ Subproblem{ std::vector<int>{} } });
-            if (queues[0]->want_producer())
-                queues[0]->initial_producer_done();
+            /* one deque per thread, and how many threads are doing something
+             * which might put work in their deque */
+            std::vector<std::unique_ptr<WorkStealingDeque> > deques;
+            for (unsigned i = 0 ; i < params.n_threads ; ++i)
+                deques.push_back(std::unique_ptr<WorkStealingDeque>{ new WorkStealingDeque{ graph.size() } });
+            std::atomic<unsigned> number_busy{ 1 };
 
-            /* threads and steal points */
+            /* threads */
             std::list<std::thread> threads;
-            std::vector<StealPoints> thread_steal_points(params.n_threads);
 
             // initial colouring
-            std::array<VertexType_, size_ * bits_per_word> initial_p_order;
-            std::array<VertexType_, size_ * bits_per_word> initial_colours;
+            VertexArray<size_, VertexType_> initial_p_order;
+            VertexArray<size_, VertexType_> initial_colours;
+            resize_vertex_array(initial_p_order, graph.size());
+            resize_vertex_array(initial_colours, graph.size());
             {
-                FixedBitSet<size_> initial_p;
+                BitSet<size_> initial_p;
+                initial_p.resize(graph.size());
                 initial_p.set_up_to(graph.size());
                 colour_class_order(SelectColourClassOrderOverload<perm_>(), initial_p, initial_p_order, initial_colours);
             }
 
+            start_progress(params.n_threads, initial_p_order, initial_colours, global_result);
+            best_anywhere.update(global_result.size);
+
             /* workers */
             for (unsigned i = 0 ; i < params.n_threads ; ++i) {
                 threads.push_back(std::thread([&, i] {
@@ -259,56 +186,66 @@ namespace
 
                             MaxCliqueResult local_result; // local result
 
-                            for (unsigned depth = 0 ; depth < number_of_depths ; ++depth) {
-                                if (queues[depth]->want_producer()) {
-                                    /* steal */
-                                    for (unsigned j = 0 ; j < params.n_threads ; ++j) {
-                                        if (j == i)
-                                            continue;
-
-                                        std::vector<int> stole;
-                                        if (thread_steal_points.at(j).points.at(depth - 1).steal(stole)) {
-                                            print_position(params, "stole after", stole);
-                                            stole.pop_back();
-                                            for (auto & s : stole)
-                                                --s;
-                                            while (++stole.back() < graph.size())
-                                                queues[depth]->enqueue(QueueItem{ Subproblem{ stole } });
-                                        }
-                                        else
-                                            print_position(params, "did not steal", stole);
-                                    }
-                                    queues[depth]->initial_producer_done();
-                                }
-
-                                while (true) {
-                                    // get some work to do
-                                    QueueItem args;
-                                    if (! queues[depth]->dequeue_blocking(args))
-                                        break;
-
-                                    print_position(params, "dequeued", args.subproblem.offsets);
-
-                                    std::vector<unsigned> c;
-                                    c.reserve(graph.size());
-
-                                    FixedBitSet<size_> p; // local potential additions
-                                    p.set_up_to(graph.size());
-
-                                    std::vector<int> position;
-                                    position.reserve(graph.size());
-                                    position.push_back(0);
-
-                                    // do some work
-                                    expand(c, p, initial_p_order, initial_colours, position, local_result,
-                                            &args.subproblem, &thread_steal_points.at(i));
+                            CCOExpandStack<size_, VertexType_> stack; // reused by everything we solve
+
+                            auto solve = [&] (Subproblem & subproblem) {
+                                std::vector<unsigned> c;
+                                c.reserve(graph.size());
+
+                                RangedBitSet<size_> p; // local potential additions
+                                p.resize(graph.size());
+                                p.set_up_to(graph.size());
+
+                                std::vector<int> position;
+                                position.reserve(graph.size());
+                                position.push_back(0);
+
+                                // do some work
+                                subproblem.thread = i;
+                                if (subproblem.offsets.empty())
+                                    deques[i]->open(0, graph.size());
+                                expand(stack, c, p, initial_p_order, initial_colours, position, local_result,
+                                        &subproblem, deques[i].get());
+                                if (subproblem.offsets.empty())
+                                    deques[i]->close(0);
+                                progress.idle(i, local_result.nodes);
+
+                                // record the last time we finished doing useful stuff
+                                overall_time = duration_cast<milliseconds>(steady_clock::now() - start_time);
+                            };
+
+                            /* the first thread starts at the top, and everyone
+                             * else steals */
+                            if (0 == i) {
+                                Subproblem everything;
+                                solve(everything);
+                                --number_busy;
+                            }
 
-                                    // record the last time we finished doing useful stuff
-                                    overall_time = duration_cast<milliseconds>(steady_clock::now() - start_time);
+                            while (0 != number_busy.load()) {
+                                bool stole = false;
+                                for (unsigned j = 1 ; j < params.n_threads && ! stole ; ++j) {
+                                    auto & victim = *deques[(i + j) % params.n_threads];
+                                    if (! victim.might_have_work())
+                                        continue;
+
+                                    /* count ourselves as busy before taking
+                                     * anything, so no-one sees the work
+                                     * disappear and finishes early */
+                                    ++number_busy;
+                                    Subproblem subproblem;
+                                    progress.stealing(i);
+                                    stole = victim.steal(subproblem.offsets);
+                                    progress.stolen(i, stole ? initial_p_order[graph.size() - 1 - subproblem.offsets[0]] : -1);
+                                    if (stole) {
+                                        print_position(params, "stole", subproblem.offsets);
+                                        solve(subproblem);
+                                    }
+                                    --number_busy;
                                 }
 
-                                if (depth < number_of_steal_points)
-                                    thread_steal_points.at(i).points.at(depth).finished();
+                                if (! stole)
+                                    std::this_thread::yield();
                             }
 
                             // merge results
@@ -324,6 +261,8 @@ namespace
             for (auto & t : threads)
                 t.join();
 
+            progress.stop(global_result);
+
             if (merge_queue.finish(global_result, order))
                 print_incumbent(params, global_result.size, std::vector<int>{ });
 
@@ -332,35 +271,49 @@ namespace
 
         auto increment_nodes(
                 MaxCliqueResult & local_result,
-                Subproblem * const,
-                StealPoints * const
+                Subproblem * const subproblem,
+                WorkStealingDeque * const
+                ) -> void
+        {
+            // every so often, say how far we've got, for progress reports
+            if (0 == (++local_result.nodes & 0xffff))
+                progress.counted(subproblem->thread, local_result.nodes);
+        }
+
+        auto descend(
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> & p,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const deque
                 ) -> void
         {
-            ++local_result.nodes;
+            // say which top level branch we're under before anything in it
+            // can be stolen
+            if (1 == c.size() && subproblem->offsets.size() <= 1)
+                progress.starting(subproblem->thread, c.back());
+
+            // below our subproblem, anything we do can be stolen
+            if (! (subproblem && c.size() < subproblem->offsets.size()))
+                deque->open(c.size(), p.popcount());
         }
 
-        auto recurse(
+        auto ascend(
                 std::vector<unsigned> & c,
-                FixedBitSet<size_> & p,
-                const std::array<VertexType_, size_ * bits_per_word> & initial_p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & initial_colours,
-                std::vector<int> & position,
                 MaxCliqueResult & local_result,
                 Subproblem * const subproblem,
-                StealPoints * const steal_points
+                WorkStealingDeque * const deque
                 ) -> bool
         {
-            if (steal_points && c.size() < number_of_steal_points)
-                steal_points->points.at(c.size() - 1).publish(position);
+            if (! (subproblem && c.size() < subproblem->offsets.size()))
+                deque->close(c.size());
 
-            expand(c, p, initial_p_order, initial_colours, position, local_result,
-                subproblem && c.size() < subproblem->offsets.size() ? subproblem : nullptr,
-                steal_points && c.size() < number_of_steal_points ? steal_points : nullptr);
+            // if we own this top level branch and didn't abort, we're done
+            // with it, apart from anything stolen from us
+            if (1 == c.size() && subproblem->offsets.size() <= 1 && ! params.abort->load())
+                progress.finished(subproblem->thread, c.back(), local_result.nodes);
 
-            if (steal_points && c.size() < number_of_steal_points)
-                return steal_points->points.at(c.size() - 1).unpublish_and_keep_going();
-            else
-                return true;
+            return true;
         }
 
         auto potential_new_best(
@@ -368,16 +321,20 @@ namespace
                 const std::vector<int> & position,
                 MaxCliqueResult & local_result,
                 Subproblem * const,
-                StealPoints * const
+                WorkStealingDeque * const
                 ) -> void
         {
             if (params.enumerate) {
-                if (best_anywhere.beaten_by(c.size())) {
+                // compare against the fixed bound rather than best_anywhere,
+                // so what gets counted can't depend upon timing
+                if (c.size() > params.initial_bound) {
                     ++local_result.result_count;
-                    local_result.size = c.size();
-                    local_result.members.clear();
-                    for (auto & v : c)
-                        local_result.members.insert(order[v]);
+                    if (local_result.members.empty()) {
+                        local_result.size = c.size();
+                        for (auto & v : c)
+                            local_result.members.insert(order[v]);
+                    }
+                    enumerate_found(c);
                 }
             }
             else {
@@ -387,6 +344,7 @@ namespace
                     for (auto & v : c)
                         local_result.members.insert(order[v]);
                     print_incumbent(params, local_result.size, position);
+                    progress.new_incumbent(local_result.members);
                 }
 
                 merge_queue.add(c);
@@ -398,20 +356,46 @@ namespace
             return best_anywhere.get();
         }
 
+        auto get_local_result(
+                MaxCliqueResult & local_result,
+                Subproblem * const,
+                WorkStealingDeque * const
+                ) -> MaxCliqueResult &
+        {
+            return local_result;
+        }
+
         auto get_skip_and_stop(
                 unsigned c_popcount,
                 MaxCliqueResult &,
                 Subproblem * const subproblem,
-                StealPoints * const,
-                int & skip,
+                WorkStealingDeque * const,
+                int &,
                 int &,
                 bool & keep_going
                 ) -> void
         {
-            if (subproblem && c_popcount < subproblem->offsets.size()) {
-                skip = subproblem->offsets.at(c_popcount);
+            if (subproblem && c_popcount < subproblem->offsets.size())
                 keep_going = false;
+        }
+
+        auto claim(
+                unsigned c_popcount,
+                int position,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const deque
+                ) -> bool
+        {
+            // inside our subproblem, we only take the one we're told to
+            if (subproblem && c_popcount < subproblem->offsets.size()) {
+                if (position != subproblem->offsets.at(c_popcount))
+                    return false;
+                deque->set_offset(c_popcount, position);
+                return true;
             }
+            else
+                return deque->claim(c_popcount, position);
         }
     };
 }
@@ -419,13 +403,29 @@ namespace
 template <CCOPermutations perm_, CCOInference inference_, bool merge_queue_>
 auto parasols::tcco_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
 {
-    return select_graph_size<ApplyPermInferenceMQ<TCCO, perm_, inference_, merge_queue_>::template Type, MaxCliqueResult>(
-            AllGraphSizes(), graph, params);
+    return select_graph_size<ApplyPermInferenceMQInverse<TCCO, perm_, inference_, merge_queue_, false>::template Type, MaxCliqueResult>(
+            AllGraphSizesAndDynamic(), graph, params);
+}
+
+template <CCOPermutations perm_>
+auto parasols::tcco_max_independent_set(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    return select_graph_size<ApplyPermInferenceMQInverse<TCCO, perm_, CCOInference::None, false, true>::template Type, MaxCliqueResult>(
+            AllGraphSizesAndDynamic(), graph, params);
 }
 
 template auto parasols::tcco_max_clique<CCOPermutations::None, CCOInference::None, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::tcco_max_clique<CCOPermutations::Defer1, CCOInference::None, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::tcco_max_clique<CCOPermutations::Inherit, CCOInference::None, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 
 template auto parasols::tcco_max_clique<CCOPermutations::None, CCOInference::None, true>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 template auto parasols::tcco_max_clique<CCOPermutations::Defer1, CCOInference::None, true>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
 
+template auto parasols::tcco_max_clique<CCOPermutations::None, CCOInference::LazyGlobalDomination, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::tcco_max_clique<CCOPermutations::Defer1, CCOInference::LazyGlobalDomination, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
+template auto parasols::tcco_max_clique<CCOPermutations::None, CCOInference::InfraChromatic, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::tcco_max_clique<CCOPermutations::Defer1, CCOInference::InfraChromatic, false>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
+template auto parasols::tcco_max_independent_set<CCOPermutations::None>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::tcco_max_independent_set<CCOPermutations::Defer1>(const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
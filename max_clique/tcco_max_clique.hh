@@ -17,11 +17,18 @@ namespace parasols
     template <CCOPermutations, CCOInference, bool merge_queue_>
     auto tcco_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
 
-    template <template <CCOPermutations, CCOInference, bool, unsigned, typename VertexType_> class WhichCCO_,
-             CCOPermutations perm_, CCOInference inference_, bool merge_queue_>
-    struct ApplyPermInferenceMQ
+    /**
+     * Super duper max independent set algorithm, threaded. This works on the
+     * graph as given, rather than needing its complement.
+     */
+    template <CCOPermutations>
+    auto tcco_max_independent_set(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+
+    template <template <CCOPermutations, CCOInference, bool, bool, unsigned, typename VertexType_> class WhichCCO_,
+             CCOPermutations perm_, CCOInference inference_, bool merge_queue_, bool inverse_>
+    struct ApplyPermInferenceMQInverse
     {
-        template <unsigned size_, typename VertexType_> using Type = WhichCCO_<perm_, inference_, merge_queue_, size_, VertexType_>;
+        template <unsigned size_, typename VertexType_> using Type = WhichCCO_<perm_, inference_, merge_queue_, inverse_, size_, VertexType_>;
     };
 }
 
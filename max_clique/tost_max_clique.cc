@@ -0,0 +1,236 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique/tost_max_clique.hh>
+#include <max_clique/print_incumbent.hh>
+#include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
+#include <graph/template_voodoo.hh>
+#include <threads/atomic_incumbent.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+using namespace parasols;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+    template <unsigned size_, typename VertexType_>
+    struct TOST
+    {
+        FixedBitGraph<size_> graph;
+        const MaxCliqueParams & params;
+        std::vector<int> order;
+        std::chrono::milliseconds encode_time;
+
+        MaxCliqueResult result;
+        std::mutex result_mutex;
+
+        AtomicIncumbent best_anywhere;
+
+        /**
+         * subproblems[v] is an upper bound on the size of a clique using
+         * only v and later vertices, and subproblems[n] is zero. Values
+         * only ever go down, so a stale read is still a valid bound.
+         */
+        std::unique_ptr<std::atomic<unsigned>[]> subproblems;
+
+        /**
+         * For a finished level, an upper bound on the size of a clique
+         * containing that vertex and only later vertices, otherwise -1.
+         * Guarded by subproblems_mutex, which is also held when writing to
+         * subproblems.
+         */
+        std::vector<int> finished;
+        std::mutex subproblems_mutex;
+
+        TOST(const Graph & g, const MaxCliqueParams & p) :
+            params(p),
+            order(g.size()),
+            subproblems(new std::atomic<unsigned>[g.size() + 1]),
+            finished(g.size(), -1)
+        {
+            // populate our order with every vertex initially
+            std::iota(order.begin(), order.end(), 0);
+            params.order_function(g, order);
+
+            // re-encode graph as a bit graph
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
+
+            // nothing has finished, so each level might add one
+            for (int v = 0 ; v <= graph.size() ; ++v)
+                subproblems[v].store(graph.size() - v);
+        }
+
+        /**
+         * Level i has finished, and nothing containing i and later vertices
+         * beats contains. Tighten the bound for i and everything before it,
+         * stopping as soon as nothing changes.
+         */
+        auto finish_level(int i, unsigned contains) -> void
+        {
+            std::unique_lock<std::mutex> guard(subproblems_mutex);
+
+            finished[i] = contains;
+            for (int v = i ; v >= 0 ; --v) {
+                unsigned after = subproblems[v + 1].load();
+                unsigned bound = -1 == finished[v] ? after + 1 : std::max<unsigned>(after, finished[v]);
+                if (bound >= subproblems[v].load())
+                    break;
+                subproblems[v].store(bound);
+            }
+        }
+
+        auto found_new_best(const std::vector<unsigned> & c, const std::vector<int> & position) -> void
+        {
+            if (! best_anywhere.update(c.size()))
+                return;
+
+            std::unique_lock<std::mutex> guard(result_mutex);
+            if (c.size() > result.size) {
+                result.size = c.size();
+
+                result.members.clear();
+                for (auto & v : c)
+                    result.members.insert(order[v]);
+
+                print_incumbent(params, c.size(), position);
+            }
+        }
+
+        auto expand(
+                MaxCliqueResult & local_result,
+                int level,
+                std::vector<unsigned> & c,
+                FixedBitSet<size_> & p,
+                std::vector<int> & position,
+                bool & found
+                ) -> void
+        {
+            ++local_result.nodes;
+
+            while (! p.empty()) {
+                ++position.back();
+
+                auto v = p.first_set_bit();
+
+                // bound, timeout or early exit?
+                unsigned best = best_anywhere.get();
+                if (c.size() + p.popcount() <= best || c.size() + subproblems[v].load() <= best ||
+                        best >= params.stop_after_finding || params.abort->load())
+                    return;
+
+                // consider taking v
+                c.push_back(v);
+
+                // filter p to contain vertices adjacent to v
+                FixedBitSet<size_> new_p = p;
+                if (graph.intersect_with_row_and_test_empty(v, new_p)) {
+                    found_new_best(c, position);
+
+                    // nothing containing level can be bigger than this?
+                    if (c.size() > subproblems[level + 1].load())
+                        found = true;
+                }
+                else {
+                    position.push_back(0);
+                    expand(local_result, level, c, new_p, position, found);
+                    position.pop_back();
+                }
+
+                // now consider not taking v
+                c.pop_back();
+                p.unset(v);
+
+                if (found)
+                    break;
+            }
+        }
+
+        auto run_level(MaxCliqueResult & local_result, int i) -> void
+        {
+            std::vector<unsigned> c;
+            c.reserve(graph.size());
+            c.push_back(i);
+
+            std::vector<int> positions;
+            positions.reserve(graph.size());
+            positions.push_back(i);
+            positions.push_back(0);
+
+            // potential additions are the later neighbours of i
+            FixedBitSet<size_> p;
+            for (int j = i + 1 ; j < graph.size() ; ++j)
+                p.set(j);
+
+            ++local_result.nodes;
+            if (graph.intersect_with_row_and_test_empty(i, p))
+                found_new_best(c, positions);
+            else {
+                bool found = false;
+                expand(local_result, i, c, p, positions, found);
+            }
+
+            // the level only counts as finished if we didn't give up early
+            unsigned best = best_anywhere.get();
+            if (best >= params.stop_after_finding || params.abort->load())
+                return;
+
+            positions.pop_back();
+            print_position(params, "level is " + std::to_string(best), positions);
+            finish_level(i, best);
+        }
+
+        auto run() -> MaxCliqueResult
+        {
+            auto start_time = steady_clock::now();
+
+            result.size = params.initial_bound;
+            result.times.push_back(encode_time);
+            best_anywhere.update(params.initial_bound);
+
+            // levels are taken from the end, and each can only start once
+            // everything after it has been started
+            std::atomic<int> next{ graph.size() - 1 };
+
+            auto work = [&] () {
+                MaxCliqueResult local_result;
+
+                for (int i ; (i = next.fetch_sub(1)) >= 0 ; ) {
+                    if (best_anywhere.get() >= params.stop_after_finding || params.abort->load())
+                        break;
+                    run_level(local_result, i);
+                }
+
+                std::unique_lock<std::mutex> guard(result_mutex);
+                result.merge(local_result);
+                result.times.push_back(duration_cast<milliseconds>(steady_clock::now() - start_time));
+            };
+
+            std::list<std::thread> threads;
+            for (unsigned t = 1 ; t < params.n_threads ; ++t)
+                threads.push_back(std::thread(work));
+
+            work();
+
+            for (auto & t : threads)
+                t.join();
+
+            return result;
+        }
+    };
+}
+
+auto parasols::tost_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    return select_graph_size<TOST, MaxCliqueResult>(AllGraphSizes(), graph, params);
+}
+
@@ -0,0 +1,26 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_TOST_MAX_CLIQUE_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_TOST_MAX_CLIQUE_HH 1
+
+#include <graph/graph.hh>
+#include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
+
+namespace parasols
+{
+    /**
+     * Ostergard's max clique algorithm, threaded.
+     *
+     * Each level of the doll, i, looks for the biggest clique containing
+     * vertex i and only vertices after it, and threads take levels from the
+     * end in turn, so several levels run at once. The bound for the vertices
+     * from v onwards comes from whichever levels after v have finished,
+     * assuming that each level which hasn't can add one to the level after
+     * it. A level's result is published, and these bounds tightened, as soon
+     * as it finishes.
+     */
+    auto tost_max_clique(const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+}
+
+#endif
@@ -0,0 +1,6 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique_mpi/algorithms.hh>
+
+using namespace parasols;
+
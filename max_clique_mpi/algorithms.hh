@@ -0,0 +1,19 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_MPI_ALGORITHMS_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_MPI_ALGORITHMS_HH 1
+
+#include <max_clique_mpi/mpicco_max_clique.hh>
+
+#include <utility>
+#include <string>
+
+namespace parasols
+{
+    auto mpi_max_clique_algorithms = {
+        std::make_pair( std::string{ "mpiccon" },   mpicco_max_clique<CCOPermutations::None>),
+        std::make_pair( std::string{ "mpiccod" },   mpicco_max_clique<CCOPermutations::Defer1>)
+    };
+}
+
+#endif
@@ -0,0 +1,26 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique_mpi/broadcast_graph.hh>
+
+#include <boost/mpi/collectives.hpp>
+
+using namespace parasols;
+
+auto parasols::broadcast_graph(const boost::mpi::communicator & world, Graph & graph, int root) -> void
+{
+    int size = graph.size();
+    bool add_one_for_output = graph.add_one_for_output();
+    boost::mpi::broadcast(world, size, root);
+    boost::mpi::broadcast(world, add_one_for_output, root);
+
+    if (world.rank() != root)
+        graph = Graph(size, add_one_for_output);
+
+    // everyone knows how big it is now, so this goes straight to MPI
+    auto & adjacency = graph.adjaceny_matrix();
+    boost::mpi::broadcast(world, adjacency.data(), adjacency.size(), root);
+
+    if (world.rank() != root)
+        graph.recalculate_degrees();
+}
+
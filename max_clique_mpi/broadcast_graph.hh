@@ -0,0 +1,20 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_MPI_BROADCAST_GRAPH_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_MPI_BROADCAST_GRAPH_HH 1
+
+#include <graph/graph.hh>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parasols
+{
+    /**
+     * Make every rank's graph a copy of root's. The adjacency matrix is sent
+     * as it is, in one go, rather than an edge at a time. Every rank must
+     * call this; what the other ranks had in graph is thrown away.
+     */
+    auto broadcast_graph(const boost::mpi::communicator & world, Graph & graph, int root) -> void;
+}
+
+#endif
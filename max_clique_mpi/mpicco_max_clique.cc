@@ -0,0 +1,596 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <max_clique_mpi/mpicco_max_clique.hh>
+#include <max_clique/cco_base.hh>
+#include <max_clique/print_incumbent.hh>
+
+#include <threads/work_stealing_deque.hh>
+#include <threads/atomic_incumbent.hh>
+
+#include <graph/template_voodoo.hh>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
+using namespace parasols;
+
+namespace mpi = boost::mpi;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+namespace
+{
+    /**
+     * What a message is. Every message carries a (possibly empty) vector of
+     * ints, and is only ever sent or received by the main thread of a rank.
+     */
+    enum Tag
+    {
+        tag_steal,          // please give me some work
+        tag_work,           // a subproblem: the credit, then the offsets
+        tag_no_work,        // nothing to give
+        tag_credit,         // to rank 0: I've run out, here's my credit
+        tag_incumbent,      // someone has found a clique this big
+        tag_done            // from rank 0: everyone has run out
+    };
+
+    /**
+     * How long the main thread, or an idle worker on a rank with nothing to
+     * do, sleeps if there was nothing for it.
+     */
+    const constexpr std::chrono::microseconds poll_interval{ 100 };
+
+    struct Subproblem
+    {
+        std::vector<int> offsets;
+    };
+
+    /**
+     * Credit handed back to rank 0, as a sum of powers of a half. Whoever
+     * holds the whole search to begin with has all of it, and giving work
+     * away splits it in two, so once all of it has come back, nobody has
+     * anything left to do and no work can still be in flight.
+     */
+    class Credit
+    {
+        private:
+            /// Bit k set means we have 2^-k.
+            std::vector<bool> _halves;
+            bool _all = false;
+
+        public:
+            auto add(int k) -> void
+            {
+                for ( ; k > 0 ; --k) {
+                    if (_halves.size() <= unsigned(k))
+                        _halves.resize(k + 1, false);
+
+                    if (! _halves[k]) {
+                        _halves[k] = true;
+                        return;
+                    }
+
+                    _halves[k] = false;
+                }
+
+                _all = true;
+            }
+
+            auto all() const -> bool
+            {
+                return _all;
+            }
+    };
+
+    /**
+     * A message that hasn't gone yet, and what's in it.
+     */
+    struct PendingSend
+    {
+        std::vector<int> data;
+        mpi::request request;
+    };
+
+    template <CCOPermutations perm_, unsigned size_, typename VertexType_>
+    struct MPICCO : CCOBase<perm_, CCOInference::None, size_, VertexType_, MPICCO<perm_, size_, VertexType_> >
+    {
+        using Base = CCOBase<perm_, CCOInference::None, size_, VertexType_, MPICCO<perm_, size_, VertexType_> >;
+
+        using Base::graph;
+        using Base::params;
+        using Base::expand;
+        using Base::order;
+        using Base::encode_time;
+        using Base::colour_class_order;
+        using Base::enumerate_found;
+
+        const mpi::communicator & world;
+
+        AtomicIncumbent best_anywhere; // global incumbent, as far as we know
+
+        /* one deque per thread, and how many threads are doing something, or
+         * have been given something to do from another rank */
+        std::vector<std::unique_ptr<WorkStealingDeque> > deques;
+        std::atomic<unsigned> number_busy;
+        std::atomic<bool> finished;
+
+        /* subproblems from another rank, waiting for a thread */
+        std::deque<Subproblem> incoming;
+        std::mutex incoming_mutex;
+
+        MPICCO(const Graph & g, const MaxCliqueParams & p, const mpi::communicator & w) :
+            Base(g, p),
+            world(w)
+        {
+        }
+
+        auto run() -> MaxCliqueResult
+        {
+            best_anywhere.update(params.initial_bound);
+
+            MaxCliqueResult rank_result;
+            rank_result.size = params.initial_bound;
+            milliseconds rank_time{ 0 };
+            std::mutex rank_result_mutex;
+
+            for (unsigned i = 0 ; i < params.n_threads ; ++i)
+                deques.push_back(std::unique_ptr<WorkStealingDeque>{ new WorkStealingDeque{ graph.size() } });
+
+            /* rank 0 starts with everything, and everyone else starts off
+             * asking for some */
+            number_busy.store(0 == world.rank() ? 1 : 0);
+            finished.store(false);
+
+            /* threads */
+            std::list<std::thread> threads;
+
+            // initial colouring
+            VertexArray<size_, VertexType_> initial_p_order;
+            VertexArray<size_, VertexType_> initial_colours;
+            resize_vertex_array(initial_p_order, graph.size());
+            resize_vertex_array(initial_colours, graph.size());
+            {
+                BitSet<size_> initial_p;
+                initial_p.resize(graph.size());
+                initial_p.set_up_to(graph.size());
+                colour_class_order(SelectColourClassOrderOverload<perm_>(), initial_p, initial_p_order, initial_colours);
+            }
+
+            /* workers */
+            for (unsigned i = 0 ; i < params.n_threads ; ++i) {
+                threads.push_back(std::thread([&, i] {
+                            auto start_time = steady_clock::now(); // local start time
+                            auto overall_time = duration_cast<milliseconds>(steady_clock::now() - start_time);
+
+                            MaxCliqueResult local_result; // local result
+
+                            CCOExpandStack<size_, VertexType_> stack; // reused by everything we solve
+
+                            auto solve = [&] (Subproblem & subproblem) {
+                                std::vector<unsigned> c;
+                                c.reserve(graph.size());
+
+                                RangedBitSet<size_> p; // local potential additions
+                                p.resize(graph.size());
+                                p.set_up_to(graph.size());
+
+                                std::vector<int> position;
+                                position.reserve(graph.size());
+                                position.push_back(0);
+
+                                // do some work
+                                if (subproblem.offsets.empty())
+                                    deques[i]->open(0, graph.size());
+                                expand(stack, c, p, initial_p_order, initial_colours, position, local_result,
+                                        &subproblem, deques[i].get());
+                                if (subproblem.offsets.empty())
+                                    deques[i]->close(0);
+
+                                // record the last time we finished doing useful stuff
+                                overall_time = duration_cast<milliseconds>(steady_clock::now() - start_time);
+                            };
+
+                            /* the first thread on rank 0 starts at the top,
+                             * and everyone else steals */
+                            if (0 == world.rank() && 0 == i) {
+                                Subproblem everything;
+                                solve(everything);
+                                --number_busy;
+                            }
+
+                            while (! finished.load()) {
+                                /* has another rank given us something? The
+                                 * main thread counted it as busy for us. */
+                                Subproblem subproblem;
+                                bool given = false;
+                                {
+                                    std::unique_lock<std::mutex> guard(incoming_mutex);
+                                    if (! incoming.empty()) {
+                                        subproblem = std::move(incoming.front());
+                                        incoming.pop_front();
+                                        given = true;
+                                    }
+                                }
+
+                                if (given) {
+                                    solve(subproblem);
+                                    --number_busy;
+                                    continue;
+                                }
+
+                                bool stole = false;
+                                for (unsigned j = 1 ; j < params.n_threads && ! stole ; ++j) {
+                                    auto & victim = *deques[(i + j) % params.n_threads];
+                                    if (! victim.might_have_work())
+                                        continue;
+
+                                    /* count ourselves as busy before taking
+                                     * anything, so no-one sees the work
+                                     * disappear and thinks we've run out */
+                                    ++number_busy;
+                                    if (victim.steal(subproblem.offsets)) {
+                                        print_position(params, "stole", subproblem.offsets);
+                                        stole = true;
+                                        solve(subproblem);
+                                    }
+                                    --number_busy;
+                                }
+
+                                if (stole)
+                                    continue;
+                                else if (0 == number_busy.load())
+                                    std::this_thread::sleep_for(poll_interval);
+                                else
+                                    std::this_thread::yield();
+                            }
+
+                            // merge results
+                            {
+                                std::unique_lock<std::mutex> guard(rank_result_mutex);
+                                rank_result.merge(local_result);
+                                rank_time = std::max(rank_time, overall_time);
+                            }
+                            }));
+            }
+
+            communicate();
+
+            // wait until they're done, and clean up threads
+            for (auto & t : threads)
+                t.join();
+
+            return gather(rank_result, rank_time);
+        }
+
+        /**
+         * What the main thread of each rank does, until rank 0 says
+         * everything is finished: deal with messages, tell everyone else
+         * about new incumbents, and if none of our threads have anything
+         * to do, hand back our credit and ask another rank for some work.
+         */
+        auto communicate() -> void
+        {
+            int rank = world.rank(), n_ranks = world.size();
+
+            // we look after 2^-credit of the search, or nothing if -1
+            int credit = (0 == rank) ? 0 : -1;
+            Credit returned; // rank 0 only
+
+            bool asked = false;
+            int victim = rank;
+            unsigned shared = best_anywhere.get();
+
+            std::list<PendingSend> sends;
+            auto send = [&] (int destination, Tag tag, std::vector<int> && data) {
+                sends.push_back(PendingSend{ std::move(data), mpi::request() });
+                sends.back().request = world.isend(destination, tag, sends.back().data);
+            };
+
+            while (! finished.load()) {
+                bool did_something = false;
+
+                while (auto status = world.iprobe(mpi::any_source, mpi::any_tag)) {
+                    did_something = true;
+                    std::vector<int> data;
+                    world.recv(status->source(), status->tag(), data);
+
+                    switch (status->tag()) {
+                        case tag_steal:
+                            {
+                                // if we have anything, it'll be in a deque
+                                Subproblem subproblem;
+                                bool stole = false;
+                                if (-1 != credit)
+                                    for (auto & deque : deques)
+                                        if (deque->might_have_work() && deque->steal(subproblem.offsets)) {
+                                            stole = true;
+                                            break;
+                                        }
+
+                                if (stole) {
+                                    // they get half of what we had
+                                    print_position(params, "sent to " + std::to_string(status->source()), subproblem.offsets);
+                                    subproblem.offsets.insert(subproblem.offsets.begin(), ++credit);
+                                    send(status->source(), tag_work, std::move(subproblem.offsets));
+                                }
+                                else
+                                    send(status->source(), tag_no_work, { });
+                            }
+                            break;
+
+                        case tag_work:
+                            credit = data.front();
+                            ++number_busy;
+                            {
+                                std::unique_lock<std::mutex> guard(incoming_mutex);
+                                incoming.push_back(Subproblem{ std::vector<int>(data.begin() + 1, data.end()) });
+                            }
+                            asked = false;
+                            break;
+
+                        case tag_no_work:
+                            asked = false;
+                            break;
+
+                        case tag_credit:
+                            returned.add(data.front());
+                            break;
+
+                        case tag_incumbent:
+                            shared = std::max<unsigned>(shared, data.front());
+                            if (best_anywhere.update(data.front()))
+                                print_incumbent(params, data.front());
+                            break;
+
+                        case tag_done:
+                            finished.store(true);
+                            break;
+                    }
+                }
+
+                // tell everyone else about anything better we've found
+                unsigned best = best_anywhere.get();
+                if (best > shared) {
+                    shared = best;
+                    for (int r = 0 ; r < n_ranks ; ++r)
+                        if (r != rank)
+                            send(r, tag_incumbent, { int(best) });
+                }
+
+                // nothing left to do here?
+                if (0 == number_busy.load() && ! finished.load()) {
+                    if (-1 != credit) {
+                        if (0 == rank)
+                            returned.add(credit);
+                        else
+                            send(0, tag_credit, { credit });
+                        credit = -1;
+                    }
+
+                    if (0 == rank && returned.all()) {
+                        for (int r = 1 ; r < n_ranks ; ++r)
+                            send(r, tag_done, { });
+                        finished.store(true);
+                    }
+                    else if (! asked && n_ranks > 1) {
+                        victim = (victim + 1) % n_ranks;
+                        if (victim == rank)
+                            victim = (victim + 1) % n_ranks;
+                        send(victim, tag_steal, { });
+                        asked = true;
+                    }
+                }
+
+                sends.remove_if([] (PendingSend & s) { return bool(s.request.test()); });
+
+                if (! did_something)
+                    std::this_thread::sleep_for(poll_interval);
+            }
+
+            /* Someone might still be asking us for work, or telling us
+             * about an incumbent. Keep taking anything sent to us until our
+             * own messages have gone and every rank has got this far, so
+             * nothing is left half sent. */
+            auto discard = [&] {
+                while (auto status = world.iprobe(mpi::any_source, mpi::any_tag)) {
+                    std::vector<int> data;
+                    world.recv(status->source(), status->tag(), data);
+                }
+            };
+
+            while (! sends.empty()) {
+                discard();
+                sends.remove_if([] (PendingSend & s) { return bool(s.request.test()); });
+            }
+
+            MPI_Request barrier;
+            MPI_Ibarrier(MPI_Comm(world), &barrier);
+            for (int everyone_done = 0 ; ! everyone_done ; ) {
+                discard();
+                MPI_Test(&barrier, &everyone_done, MPI_STATUS_IGNORE);
+            }
+        }
+
+        /**
+         * Put together everyone's results on rank 0. Other ranks just get
+         * their own back.
+         */
+        auto gather(MaxCliqueResult & rank_result, milliseconds rank_time) -> MaxCliqueResult
+        {
+            std::vector<int> members{ rank_result.members.begin(), rank_result.members.end() };
+            std::vector<std::vector<int> > all_members;
+            mpi::gather(world, members, all_members, 0);
+
+            std::vector<unsigned long long> all_nodes, all_counts;
+            mpi::gather(world, rank_result.nodes, all_nodes, 0);
+            mpi::gather(world, rank_result.result_count, all_counts, 0);
+
+            std::vector<long long> all_times;
+            mpi::gather(world, static_cast<long long>(rank_time.count()), all_times, 0);
+
+            if (0 != world.rank()) {
+                rank_result.times.push_back(encode_time);
+                rank_result.times.push_back(rank_time);
+                return rank_result;
+            }
+
+            MaxCliqueResult result;
+            result.size = params.initial_bound;
+            result.times.push_back(encode_time);
+
+            for (int r = 0 ; r < world.size() ; ++r) {
+                result.nodes += all_nodes[r];
+                result.result_count += all_counts[r];
+
+                if (all_members[r].size() > result.size) {
+                    result.size = all_members[r].size();
+                    result.members = std::set<int>{ all_members[r].begin(), all_members[r].end() };
+                }
+
+                result.times.push_back(milliseconds(all_times[r]));
+            }
+
+            return result;
+        }
+
+        auto increment_nodes(
+                MaxCliqueResult & local_result,
+                Subproblem * const,
+                WorkStealingDeque * const
+                ) -> void
+        {
+            ++local_result.nodes;
+        }
+
+        auto descend(
+                std::vector<unsigned> & c,
+                RangedBitSet<size_> & p,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const deque
+                ) -> void
+        {
+            // below our subproblem, anything we do can be stolen
+            if (! (subproblem && c.size() < subproblem->offsets.size()))
+                deque->open(c.size(), p.popcount());
+        }
+
+        auto ascend(
+                std::vector<unsigned> & c,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const deque
+                ) -> bool
+        {
+            if (! (subproblem && c.size() < subproblem->offsets.size()))
+                deque->close(c.size());
+
+            return true;
+        }
+
+        auto potential_new_best(
+                const std::vector<unsigned> & c,
+                const std::vector<int> & position,
+                MaxCliqueResult & local_result,
+                Subproblem * const,
+                WorkStealingDeque * const
+                ) -> void
+        {
+            if (params.enumerate) {
+                if (c.size() > params.initial_bound) {
+                    ++local_result.result_count;
+                    if (local_result.members.empty()) {
+                        local_result.size = c.size();
+                        for (auto & v : c)
+                            local_result.members.insert(order[v]);
+                    }
+                    enumerate_found(c);
+                }
+            }
+            else if (best_anywhere.update(c.size())) {
+                local_result.size = c.size();
+                local_result.members.clear();
+                for (auto & v : c)
+                    local_result.members.insert(order[v]);
+                print_incumbent(params, local_result.size, position);
+            }
+        }
+
+        auto get_best_anywhere_value() -> unsigned
+        {
+            return best_anywhere.get();
+        }
+
+        auto get_local_result(
+                MaxCliqueResult & local_result,
+                Subproblem * const,
+                WorkStealingDeque * const
+                ) -> MaxCliqueResult &
+        {
+            return local_result;
+        }
+
+        auto get_skip_and_stop(
+                unsigned c_popcount,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const,
+                int &,
+                int &,
+                bool & keep_going
+                ) -> void
+        {
+            if (subproblem && c_popcount < subproblem->offsets.size())
+                keep_going = false;
+        }
+
+        auto claim(
+                unsigned c_popcount,
+                int position,
+                MaxCliqueResult &,
+                Subproblem * const subproblem,
+                WorkStealingDeque * const deque
+                ) -> bool
+        {
+            // inside our subproblem, we only take the one we're told to
+            if (subproblem && c_popcount < subproblem->offsets.size()) {
+                if (position != subproblem->offsets.at(c_popcount))
+                    return false;
+                deque->set_offset(c_popcount, position);
+                return true;
+            }
+            else
+                return deque->claim(c_popcount, position);
+        }
+    };
+}
+
+template <CCOPermutations perm_>
+auto parasols::mpicco_max_clique(const mpi::communicator & world, const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult
+{
+    // our own communicator, so nothing left over from an earlier run can
+    // get mixed up with ours
+    mpi::communicator comm(world, mpi::comm_duplicate);
+
+    // only rank 0 says anything
+    MaxCliqueParams rank_params = params;
+    if (0 != comm.rank())
+        rank_params.print_incumbents = false;
+
+    return select_graph_size<ApplyPerm<MPICCO, perm_>::template Type, MaxCliqueResult>(
+            AllGraphSizesAndDynamic(), graph, rank_params, comm);
+}
+
+template auto parasols::mpicco_max_clique<CCOPermutations::None>(const mpi::communicator &, const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+template auto parasols::mpicco_max_clique<CCOPermutations::Defer1>(const mpi::communicator &, const Graph &, const MaxCliqueParams &) -> MaxCliqueResult;
+
@@ -0,0 +1,37 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_MAX_CLIQUE_MPI_MPICCO_MAX_CLIQUE_HH
+#define PARASOLS_GUARD_MAX_CLIQUE_MPI_MPICCO_MAX_CLIQUE_HH 1
+
+#include <graph/graph.hh>
+#include <cco/cco.hh>
+#include <max_clique/max_clique_params.hh>
+#include <max_clique/max_clique_result.hh>
+
+#include <boost/mpi/communicator.hpp>
+
+namespace parasols
+{
+    /**
+     * Super duper max clique algorithm, threaded, and spread over every rank
+     * of world.
+     *
+     * Every rank must call this at the same time, with the same graph (see
+     * broadcast_graph()) and params. Each rank searches using
+     * params.n_threads threads, sharing work between them as tcco does, and
+     * its main thread deals with messages. Rank 0 starts with the whole
+     * search, and a rank with nothing left to do asks the others in turn for
+     * work, getting back a subproblem as a list of offsets. Incumbents are
+     * sent to every rank as soon as they are found. Rank 0 notices when
+     * everything is finished by collecting back credit which is split up
+     * whenever work is given away, and then the result, and how long each
+     * rank spent doing useful work, is gathered on rank 0 only.
+     *
+     * Stolen subproblems are replayed from their offsets, so only the
+     * colourings which don't depend upon the incumbent are supported.
+     */
+    template <CCOPermutations>
+    auto mpicco_max_clique(const boost::mpi::communicator & world, const Graph & graph, const MaxCliqueParams & params) -> MaxCliqueResult;
+}
+
+#endif
@@ -0,0 +1,9 @@
+TARGET := libmax_clique_mpi.a
+
+SOURCES := \
+	broadcast_graph.cc \
+	mpicco_max_clique.cc \
+	algorithms.cc
+
+TGT_CXXFLAGS := $(mpi_cxxflags)
+
@@ -4,6 +4,7 @@
 #define PARASOLS_GUARD_MAX_LABELLED_CLIQUE_LCCO_BASE_HH 1
 
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
 
 #include <cco/cco.hh>
 #include <cco/cco_mixin.hh>
@@ -22,10 +23,11 @@ namespace parasols
     {
         using CCOMixin<size_, VertexType_, LCCOBase<perm_, size_, VertexType_, ActualType_>, false>::colour_class_order;
 
-        FixedBitGraph<size_> graph;
+        BitGraph<size_> graph;
         const MaxLabelledCliqueParams & params;
         std::vector<int> order;
         Labels permuted_labels;
+        std::chrono::milliseconds encode_time;
 
         LCCOBase(const Graph & g, const MaxLabelledCliqueParams & p) :
             params(p),
@@ -37,12 +39,7 @@ namespace parasols
             params.order_function(g, order);
 
             // re-encode graph as a bit graph
-            graph.resize(g.size());
-
-            for (int i = 0 ; i < g.size() ; ++i)
-                for (int j = 0 ; j < g.size() ; ++j)
-                    if (g.adjacent(order[i], order[j]))
-                        graph.add_edge(i, j);
+            encode_time = encode_bit_graph(g, order, params.n_threads, graph);
 
             for (int i = 0 ; i < g.size() ; ++i)
                 for (int j = 0 ; j < g.size() ; ++j)
@@ -53,10 +50,10 @@ namespace parasols
         auto expand(
                 bool pass_2,
                 std::vector<VertexType_> & c,                    // current candidate clique
-                FixedBitSet<size_> & p,                          // potential additions
+                BitSet<size_> & p,                          // potential additions
                 LabelSet & u,
-                const std::array<VertexType_, size_ * bits_per_word> & p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & colours,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
                 std::vector<int> & position,
                 MoreArgs_ && ... more_args_
                 ) -> void
@@ -92,7 +89,7 @@ namespace parasols
                     ++c_popcount;
 
                     // filter p to contain vertices adjacent to v
-                    FixedBitSet<size_> new_p = p;
+                    BitSet<size_> new_p = p;
                     graph.intersect_with_row(v, new_p);
 
                     // used new label?
@@ -108,8 +105,10 @@ namespace parasols
 
                         if (! new_p.empty()) {
                             position.push_back(0);
-                            std::array<VertexType_, size_ * bits_per_word> new_p_order;
-                            std::array<VertexType_, size_ * bits_per_word> new_colours;
+                            VertexArray<size_, VertexType_> new_p_order;
+                            VertexArray<size_, VertexType_> new_colours;
+                            resize_vertex_array(new_p_order, graph.size());
+                            resize_vertex_array(new_colours, graph.size());
                             colour_class_order(SelectColourClassOrderOverload<perm_>(), new_p, new_p_order, new_colours);
                             keep_going = static_cast<ActualType_ *>(this)->recurse(
                                     pass_2, c, new_p, new_u, new_p_order, new_colours, position,
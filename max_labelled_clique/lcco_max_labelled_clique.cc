@@ -24,6 +24,7 @@ namespace
         using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::params;
         using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::graph;
         using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::order;
+        using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::encode_time;
         using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::expand;
         using LCCOBase<perm_, size_, VertexType_, LCCO<perm_, size_, VertexType_> >::colour_class_order;
 
@@ -32,6 +33,7 @@ namespace
         auto run() -> MaxLabelledCliqueResult
         {
             result.size = params.initial_bound;
+            result.times.push_back(encode_time);
 
             for (unsigned pass = 1 ; pass <= 2 ; ++pass) {
                 auto start_time = steady_clock::now(); // local start time
@@ -39,7 +41,8 @@ namespace
                 std::vector<VertexType_> c;
                 c.reserve(graph.size());
 
-                FixedBitSet<size_> p; // potential additions
+                BitSet<size_> p; // potential additions
+                p.resize(graph.size());
                 p.set_up_to(graph.size());
 
                 std::vector<int> positions;
@@ -48,8 +51,10 @@ namespace
 
                 LabelSet u;
 
-                std::array<VertexType_, size_ * bits_per_word> initial_p_order;
-                std::array<VertexType_, size_ * bits_per_word> initial_colours;
+                VertexArray<size_, VertexType_> initial_p_order;
+                VertexArray<size_, VertexType_> initial_colours;
+                resize_vertex_array(initial_p_order, graph.size());
+                resize_vertex_array(initial_colours, graph.size());
                 colour_class_order(SelectColourClassOrderOverload<perm_>(), p, initial_p_order, initial_colours);
 
                 // go!
@@ -84,10 +89,10 @@ namespace
         auto recurse(
                 bool pass_2,
                 std::vector<VertexType_> & c,
-                FixedBitSet<size_> & p,
+                BitSet<size_> & p,
                 LabelSet & u,
-                const std::array<VertexType_, size_ * bits_per_word> & p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & colours,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
                 std::vector<int> & position
                 ) -> bool
         {
@@ -119,7 +124,7 @@ namespace
 template <CCOPermutations perm_>
 auto parasols::lcco_max_labelled_clique(const Graph & graph, const MaxLabelledCliqueParams & params) -> MaxLabelledCliqueResult
 {
-    return select_graph_size<ApplyPerm<LCCO, perm_>::template Type, MaxLabelledCliqueResult>(AllGraphSizes(), graph, params);
+    return select_graph_size<ApplyPerm<LCCO, perm_>::template Type, MaxLabelledCliqueResult>(AllGraphSizesAndDynamic(), graph, params);
 }
 
 template auto parasols::lcco_max_labelled_clique<CCOPermutations::None>(const Graph &, const MaxLabelledCliqueParams &) -> MaxLabelledCliqueResult;
@@ -120,6 +120,7 @@ namespace
         using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::params;
         using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::graph;
         using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::order;
+        using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::encode_time;
         using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::expand;
         using LCCOBase<perm_, size_, VertexType_, TLCCO<perm_, size_, VertexType_> >::colour_class_order;
 
@@ -136,6 +137,7 @@ namespace
 
             MaxLabelledCliqueResult global_result;
             global_result.size = params.initial_bound;
+            global_result.times.push_back(encode_time);
             std::mutex global_result_mutex;
 
             for (unsigned pass = 1 ; pass <= 2 ; ++pass) {
@@ -156,10 +158,13 @@ namespace
                 std::vector<StealPoints> thread_steal_points(params.n_threads);
 
                 // initial colouring
-                std::array<VertexType_, size_ * bits_per_word> initial_p_order;
-                std::array<VertexType_, size_ * bits_per_word> initial_colours;
+                VertexArray<size_, VertexType_> initial_p_order;
+                VertexArray<size_, VertexType_> initial_colours;
+                resize_vertex_array(initial_p_order, graph.size());
+                resize_vertex_array(initial_colours, graph.size());
                 {
-                    FixedBitSet<size_> initial_p;
+                    BitSet<size_> initial_p;
+                    initial_p.resize(graph.size());
                     initial_p.set_up_to(graph.size());
                     colour_class_order(SelectColourClassOrderOverload<perm_>(), initial_p, initial_p_order, initial_colours);
                 }
@@ -205,7 +210,8 @@ namespace
                                         std::vector<VertexType_> c;
                                         c.reserve(graph.size());
 
-                                        FixedBitSet<size_> p; // local potential additions
+                                        BitSet<size_> p; // local potential additions
+                                        p.resize(graph.size());
                                         p.set_up_to(graph.size());
 
                                         std::vector<int> position;
@@ -269,10 +275,10 @@ namespace
         auto recurse(
                 bool pass_2,
                 std::vector<VertexType_> & c,
-                FixedBitSet<size_> & p,
+                BitSet<size_> & p,
                 LabelSet & u,
-                const std::array<VertexType_, size_ * bits_per_word> & p_order,
-                const std::array<VertexType_, size_ * bits_per_word> & colours,
+                const VertexArray<size_, VertexType_> & p_order,
+                const VertexArray<size_, VertexType_> & colours,
                 std::vector<int> & position,
                 MaxLabelledCliqueResult & local_result,
                 Subproblem * const subproblem,
@@ -330,7 +336,7 @@ namespace
 template <CCOPermutations perm_>
 auto parasols::tlcco_max_labelled_clique(const Graph & graph, const MaxLabelledCliqueParams & params) -> MaxLabelledCliqueResult
 {
-    return select_graph_size<ApplyPerm<TLCCO, perm_>::template Type, MaxLabelledCliqueResult>(AllGraphSizes(), graph, params);
+    return select_graph_size<ApplyPerm<TLCCO, perm_>::template Type, MaxLabelledCliqueResult>(AllGraphSizesAndDynamic(), graph, params);
 }
 
 template auto parasols::tlcco_max_labelled_clique<CCOPermutations::None>(const Graph &, const MaxLabelledCliqueParams &) -> MaxLabelledCliqueResult;
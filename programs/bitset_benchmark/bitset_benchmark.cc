@@ -0,0 +1,175 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <graph/bit_kernels.hh>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <cstdlib>
+
+using namespace parasols;
+namespace po = boost::program_options;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+
+namespace
+{
+    /* Stop the compiler from hoisting repeated calls on unchanged data out of
+     * the timing loop. */
+    auto clobber(const void * p) -> void
+    {
+        asm volatile("" : : "r"(p) : "memory");
+    }
+
+    /* The results have to go somewhere, or the compiler gets clever. */
+    volatile unsigned long long sink;
+
+    struct Operation
+    {
+        std::string name;
+        std::function<void (BitWord *, const BitWord *, unsigned)> scalar;
+        std::function<void (BitWord *, const BitWord *, unsigned)> selected;
+        bool a_only_last_bit;
+    };
+
+    auto time_kernel(
+            const std::function<void (BitWord *, const BitWord *, unsigned)> & kernel,
+            std::vector<BitWord> & a, const std::vector<BitWord> & b,
+            unsigned long long repeats, int trials) -> double
+    {
+        /* Take the best of several trials, to filter out noise from whatever
+         * else the machine is doing. */
+        double best = 0.0;
+        for (int t = 0 ; t < trials ; ++t) {
+            auto start_time = steady_clock::now();
+            for (unsigned long long r = 0 ; r < repeats ; ++r) {
+                kernel(a.data(), b.data(), a.size());
+                clobber(a.data());
+            }
+            auto total_time = duration_cast<nanoseconds>(steady_clock::now() - start_time);
+            double this_time = double(total_time.count()) / repeats;
+            if (0 == t || this_time < best)
+                best = this_time;
+        }
+        return best;
+    }
+}
+
+auto main(int argc, char * argv[]) -> int
+{
+    try {
+        po::options_description display_options{ "Program options" };
+        display_options.add_options()
+            ("help",                                          "Display help information")
+            ("work",        po::value<int>()->default_value(26),
+                                                              "Process 2^work words for each kernel and size")
+            ("trials",      po::value<int>()->default_value(5), "Report the best of this many trials")
+            ("seed",        po::value<int>()->default_value(0), "The seed")
+            ;
+
+        po::variables_map options_vars;
+        po::store(po::command_line_parser(argc, argv)
+                .options(display_options)
+                .run(), options_vars);
+        po::notify(options_vars);
+
+        /* --help? Show a message, and exit. */
+        if (options_vars.count("help")) {
+            std::cout << "Usage: " << argv[0] << " [options]" << std::endl;
+            std::cout << std::endl;
+            std::cout << display_options << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        unsigned long long work = 1ull << options_vars["work"].as<int>();
+        int trials = options_vars["trials"].as<int>();
+
+        std::mt19937_64 rand;
+        rand.seed(options_vars["seed"].as<int>());
+
+        std::vector<Operation> operations{
+            { "intersect",
+                [] (BitWord * a, const BitWord * b, unsigned n) { bit_kernels::scalar::intersect(a, b, n); },
+                [] (BitWord * a, const BitWord * b, unsigned n) { bit_kernels::intersect(a, b, n); },
+                false },
+            { "intersect_complement",
+                [] (BitWord * a, const BitWord * b, unsigned n) { bit_kernels::scalar::intersect_complement(a, b, n); },
+                [] (BitWord * a, const BitWord * b, unsigned n) { bit_kernels::intersect_complement(a, b, n); },
+                false },
+            { "popcount",
+                [] (BitWord * a, const BitWord *, unsigned n) { sink = bit_kernels::scalar::popcount(a, n); },
+                [] (BitWord * a, const BitWord *, unsigned n) { sink = bit_kernels::popcount(a, n); },
+                false },
+            { "first_set_bit",
+                [] (BitWord * a, const BitWord *, unsigned n) { sink = bit_kernels::scalar::first_set_bit(a, n); },
+                [] (BitWord * a, const BitWord *, unsigned n) { sink = bit_kernels::first_set_bit(a, n); },
+                true },
+            { "intersect_and_popcount",
+                [] (BitWord * a, const BitWord * b, unsigned n) { sink = bit_kernels::scalar::intersect_and_popcount(a, b, n); },
+                [] (BitWord * a, const BitWord * b, unsigned n) { sink = bit_kernels::intersect_and_popcount(a, b, n); },
+                false },
+            { "intersect_and_test_empty",
+                [] (BitWord * a, const BitWord * b, unsigned n) { sink = bit_kernels::scalar::intersect_and_test_empty(a, b, n); },
+                [] (BitWord * a, const BitWord * b, unsigned n) { sink = bit_kernels::intersect_and_test_empty(a, b, n); },
+                false },
+            { "intersect_then_popcount",
+                [] (BitWord * a, const BitWord * b, unsigned n) {
+                    bit_kernels::scalar::intersect(a, b, n);
+                    sink = bit_kernels::scalar::popcount(a, n); },
+                [] (BitWord * a, const BitWord * b, unsigned n) {
+                    bit_kernels::intersect(a, b, n);
+                    sink = bit_kernels::popcount(a, n); },
+                false }
+        };
+
+        std::cout << "# kernels: " << bit_kernels::selected_name() << std::endl;
+        std::cout << "# words operation scalar_ns selected_ns speedup" << std::endl;
+
+        for (unsigned words = 8 ; words <= 1024 ; words *= 2) {
+            std::vector<BitWord> a0(words), b(words);
+            for (auto & w : a0)
+                w = rand();
+            /* Intersecting with b repeatedly shouldn't empty a. */
+            for (auto & w : b)
+                w = rand() | rand();
+
+            std::vector<BitWord> only_last_bit(words, 0);
+            only_last_bit.back() = BitWord{ 1 } << (bits_per_word - 1);
+
+            unsigned long long repeats = work / words;
+
+            for (auto & operation : operations) {
+                std::vector<BitWord> a = operation.a_only_last_bit ? only_last_bit : a0;
+                double scalar_time = time_kernel(operation.scalar, a, b, repeats, trials);
+
+                a = operation.a_only_last_bit ? only_last_bit : a0;
+                double selected_time = time_kernel(operation.selected, a, b, repeats, trials);
+
+                std::cout << std::setw(5) << words << " " << std::left << std::setw(25) << operation.name << std::right
+                    << std::fixed << std::setprecision(1)
+                    << " " << std::setw(9) << scalar_time << " " << std::setw(9) << selected_time
+                    << std::setprecision(2) << " " << std::setw(6) << (scalar_time / selected_time) << std::endl;
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch (const po::error & e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Try " << argv[0] << " --help" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception & e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
@@ -0,0 +1,5 @@
+TARGET := bitset_benchmark
+
+SOURCES := bitset_benchmark.cc
+
+TGT_LDLIBS := $(boost_ldlibs)
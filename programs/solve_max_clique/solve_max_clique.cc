@@ -12,11 +12,19 @@
 #include <graph/add_dominated_vertices.hh>
 
 #include <max_clique/algorithms.hh>
+#include <max_clique/reduce_graph.hh>
+#include <max_clique/local_search.hh>
+#include <max_clique/print_incumbent.hh>
+#include <max_clique/checkpoint.hh>
+
+#include <threads/output_lock.hh>
 
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
 
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <exception>
 #include <cstdlib>
 #include <chrono>
@@ -31,7 +39,129 @@ using std::chrono::milliseconds;
 
 namespace
 {
+    auto run_reduced(MaxCliqueResult func(const Graph &, const MaxCliqueParams &),
+                const Graph & graph,
+                const MaxCliqueParams & params,
+                bool reduce,
+                bool reduce_colour
+            ) -> MaxCliqueResult
+    {
+        if (! reduce)
+            return func(graph, params);
+
+        // if enumerating, a greedy clique would hide others of the same size
+        auto reduce_start_time = steady_clock::now();
+        auto reduced = reduce_graph(graph, params.initial_bound, ! params.enumerate, reduce_colour);
+        auto reduce_time = duration_cast<milliseconds>(steady_clock::now() - reduce_start_time);
+
+        if (! reduced.clique.empty())
+            print_incumbent(params, reduced.clique.size());
+
+        MaxCliqueParams reduced_params = params;
+        reduced_params.initial_bound = reduced.bound;
+
+        // cliques being streamed out have to be in terms of the real graph
+        if (params.enumerate_callback && ! reduced.unchanged)
+            reduced_params.enumerate_callback = [&] (const std::vector<int> & clique) {
+                std::vector<int> members;
+                members.reserve(clique.size());
+                for (auto & v : clique)
+                    members.push_back(reduced.vertices[v]);
+                params.enumerate_callback(members);
+            };
+
+        auto result = func(reduced.unchanged ? graph : reduced.graph, reduced_params);
+
+        if (! reduced.unchanged) {
+            std::set<int> members;
+            for (auto & v : result.members)
+                members.insert(reduced.vertices[v]);
+            result.members = std::move(members);
+        }
+
+        if (result.size <= reduced.clique.size()) {
+            result.size = reduced.clique.size();
+            result.members = std::set<int>{ reduced.clique.begin(), reduced.clique.end() };
+        }
+
+        result.times.push_front(reduce_time);
+        return result;
+    }
+
+    auto run_local_searched(MaxCliqueResult func(const Graph &, const MaxCliqueParams &),
+                const Graph & graph,
+                const MaxCliqueParams & params,
+                int local_search_ms,
+                bool reduce,
+                bool reduce_colour
+            ) -> MaxCliqueResult
+    {
+        // if enumerating, a heuristic clique would hide others of the same size
+        if (0 == local_search_ms || params.enumerate)
+            return run_reduced(func, graph, params, reduce, reduce_colour);
+
+        auto local_search_start_time = steady_clock::now();
+        AtomicIncumbent incumbent;
+        incumbent.update(params.initial_bound);
+        auto clique = local_search_max_clique(graph, params, milliseconds(local_search_ms), incumbent);
+        auto local_search_time = duration_cast<milliseconds>(steady_clock::now() - local_search_start_time);
+
+        MaxCliqueParams searched_params = params;
+        searched_params.initial_bound = incumbent.get();
+        auto result = run_reduced(func, graph, searched_params, reduce, reduce_colour);
+
+        if (result.size <= clique.size()) {
+            result.size = clique.size();
+            result.members = std::set<int>{ clique.begin(), clique.end() };
+        }
+
+        result.times.push_front(local_search_time);
+        return result;
+    }
+
+    auto run_enumerated(MaxCliqueResult func(const Graph &, const MaxCliqueParams &),
+                const Graph & graph,
+                const MaxCliqueParams & params,
+                int local_search_ms,
+                bool reduce,
+                bool reduce_colour
+            ) -> MaxCliqueResult
+    {
+        // if we've been told what to beat, enumerate everything bigger than
+        // it, otherwise find omega first, and then enumerate everything that
+        // size
+        if (! params.enumerate || 0 != params.initial_bound)
+            return run_local_searched(func, graph, params, local_search_ms, reduce, reduce_colour);
+
+        auto find_start_time = steady_clock::now();
+        MaxCliqueParams find_params = params;
+        find_params.enumerate = false;
+        auto found = run_local_searched(func, graph, find_params, local_search_ms, reduce, reduce_colour);
+        auto find_time = duration_cast<milliseconds>(steady_clock::now() - find_start_time);
+
+        if (0 == found.size || params.abort->load()) {
+            found.times.push_front(find_time);
+            return found;
+        }
+
+        MaxCliqueParams enumerate_params = params;
+        enumerate_params.initial_bound = found.size - 1;
+        auto result = run_local_searched(func, graph, enumerate_params, local_search_ms, reduce, reduce_colour);
+
+        result.nodes += found.nodes;
+        if (result.members.empty()) {
+            result.size = found.size;
+            result.members = found.members;
+        }
+
+        result.times.push_front(find_time);
+        return result;
+    }
+
     auto run_with_modifications(MaxCliqueResult func(const Graph &, const MaxCliqueParams &),
+                int local_search_ms,
+                bool reduce,
+                bool reduce_colour,
                 unsigned dominated_vertices,
                 double dominated_edge_p,
                 double dominated_join_p,
@@ -53,12 +183,12 @@ namespace
                         auto power_start_time = steady_clock::now();
                         auto power_graph = power(modified_graph, params.power);
                         auto power_time = duration_cast<milliseconds>(steady_clock::now() - power_start_time);
-                        auto result = func(power_graph, params);
+                        auto result = run_enumerated(func, power_graph, params, local_search_ms, reduce, reduce_colour);
                         result.times.insert(result.times.begin(), power_time);
                         return result;
                     }
                     else
-                        return func(modified_graph, params);
+                        return run_enumerated(func, modified_graph, params, local_search_ms, reduce, reduce_colour);
                 });
     }
 }
@@ -71,15 +201,25 @@ auto main(int argc, char * argv[]) -> int
             ("help",                                 "Display help information")
             ("threads",            po::value<int>(), "Number of threads to use (where relevant)")
             ("stop-after-finding", po::value<int>(), "Stop after finding a clique of this size")
+            ("stop-at-gap",        po::value<int>(), "Stop once the clique found is within this many vertices of optimal (cco and tcco only)")
+            ("stop-at-ratio",      po::value<double>(), "Stop once the clique found is at least this fraction of optimal (cco and tcco only)")
             ("initial-bound",      po::value<int>(), "Specify an initial bound")
-            ("enumerate",                            "Enumerate solutions (use with bmcsa1 --initial-bound=omega-1 --print-incumbents)")
+            ("enumerate",                            "Count every maximum clique (or, with --initial-bound, every clique bigger than it)")
+            ("print-cliques",                        "When enumerating, print every clique as it is found")
             ("print-incumbents",                     "Print new incumbents as they are found")
+            ("print-progress",     po::value<int>(), "Print how far the search has got every this many seconds (cco and tcco only)")
             ("split-depth",        po::value<int>(), "Specify the depth at which to perform splitting (where relevant)")
             ("work-donation",                        "Enable work donation (where relevant)")
             ("timeout",            po::value<int>(), "Abort after this many seconds")
             ("complement",                           "Take the complement of the graph (to solve independent set)")
+            ("independent-set",                      "Solve independent set without taking the complement (ccon, ccod, tccon and tccod only)")
             ("power",              po::value<int>(), "Raise the graph to this power (to solve s-clique)")
             ("vertex-transitive",                    "Specify if the graph is known to be vertex transitive")
+            ("no-symmetry-breaking",                 "Don't look for automorphisms to break symmetries with")
+            ("no-shrink",                            "Don't move small subproblems into a smaller bit graph (cco and tcco only)")
+            ("local-search",       po::value<int>(), "Run a local search for up to this many ms first, to get an initial bound")
+            ("reduce",                               "Remove vertices which can't beat a greedy clique before solving")
+            ("reduce-colour",                        "When reducing, also use a colour bound on each neighbourhood")
             ("add-dominated",      po::value<int>(), "Add this many dominated vertices to the input graph")
             ("dominated-edges",    po::value<double>(), "When adding dominated vertices, keep edges with this probability")
             ("join-dominated",     po::value<double>(), "When adding dominated vertices, join dominated vertices with this probability")
@@ -87,6 +227,9 @@ auto main(int argc, char * argv[]) -> int
             ("verify",                               "Verify that we have found a valid result (for sanity checking changes)")
             ("check-club",                           "Check whether our s-clique is also an s-club")
             ("format",             po::value<std::string>(), "Specify the format of the input")
+            ("checkpoint",         po::value<std::string>(), "Periodically save how far we've got to this file (cco and tcco only)")
+            ("checkpoint-interval", po::value<int>(), "Save a checkpoint every this many seconds (default 600)")
+            ("resume",             po::value<std::string>(), "Carry on from this checkpoint file")
             ;
 
         po::options_description all_options{ "All options" };
@@ -142,6 +285,32 @@ auto main(int argc, char * argv[]) -> int
             return EXIT_FAILURE;
         }
 
+        /* Independent set variants run on the graph as given, so nothing
+         * which changes the graph to suit a clique algorithm will work. */
+        auto run_algorithm = std::get<1>(*algorithm);
+        if (options_vars.count("independent-set")) {
+            for (auto & o : { "complement", "power", "local-search", "reduce", "reduce-colour", "add-dominated", "check-club" })
+                if (options_vars.count(o)) {
+                    std::cerr << "Can't use --" << o << " with --independent-set" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+            auto independent = max_independent_set_algorithms.begin(), independent_end = max_independent_set_algorithms.end();
+            for ( ; independent != independent_end ; ++independent)
+                if (std::get<0>(*independent) == options_vars["algorithm"].as<std::string>())
+                    break;
+
+            if (independent == independent_end) {
+                std::cerr << "Algorithm " << options_vars["algorithm"].as<std::string>() << " can't do --independent-set, choose from:";
+                for (auto a : max_independent_set_algorithms)
+                    std::cerr << " " << std::get<0>(a);
+                std::cerr << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            run_algorithm = std::get<1>(*independent);
+        }
+
         /* Turn an order string name into a runnable function. */
         MaxCliqueOrderFunction order_function;
         for (auto order = orders.begin() ; order != orders.end() ; ++order)
@@ -181,15 +350,30 @@ auto main(int argc, char * argv[]) -> int
             if (options_vars.count("stop-after-finding"))
                 params.stop_after_finding = options_vars["stop-after-finding"].as<int>();
 
+            if (options_vars.count("stop-at-gap"))
+                params.stop_at_gap = options_vars["stop-at-gap"].as<int>();
+
+            if (options_vars.count("stop-at-ratio"))
+                params.stop_at_ratio = options_vars["stop-at-ratio"].as<double>();
+
             if (options_vars.count("initial-bound"))
                 params.initial_bound = options_vars["initial-bound"].as<int>();
 
-            if (options_vars.count("enumerate"))
+            if (options_vars.count("enumerate")) {
+                if (options_vars.count("stop-at-gap") || options_vars.count("stop-at-ratio")) {
+                    std::cerr << "Can't use --stop-at-gap or --stop-at-ratio with --enumerate" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
                 params.enumerate = true;
+            }
 
             if (options_vars.count("print-incumbents"))
                 params.print_incumbents = true;
 
+            if (options_vars.count("print-progress"))
+                params.progress_interval = std::chrono::seconds(options_vars["print-progress"].as<int>());
+
             if (options_vars.count("check-club"))
                 params.check_clubs = true;
 
@@ -205,6 +389,12 @@ auto main(int argc, char * argv[]) -> int
             if (options_vars.count("vertex-transitive"))
                 params.vertex_transitive = true;
 
+            if (options_vars.count("no-symmetry-breaking"))
+                params.break_symmetries = false;
+
+            if (options_vars.count("no-shrink"))
+                params.shrink_subproblems = false;
+
             unsigned dominated_vertices = 0;
             double dominated_edge_p = 1.0;
             double dominated_join_p = 0.0;
@@ -244,9 +434,68 @@ auto main(int argc, char * argv[]) -> int
 
             params.original_graph = &graph;
 
+            /* Checkpoints have to know what they're of, so we don't resume
+             * the wrong thing. */
+            MaxCliqueCheckpoint resume;
+            if (options_vars.count("checkpoint") || options_vars.count("resume")) {
+                if (options_vars.count("enumerate") || options_vars.count("local-search")) {
+                    std::cerr << "Can't use checkpoints with --enumerate or --local-search" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                unsigned long long edges = 0;
+                for (int v = 0 ; v < graph.size() ; ++v)
+                    edges += graph.degree(v);
+
+                std::stringstream key;
+                key << options_vars["algorithm"].as<std::string>() << " " << options_vars["order"].as<std::string>()
+                    << " " << graph.size() << " " << edges / 2;
+                for (auto & o : { "complement", "independent-set", "reduce", "reduce-colour", "vertex-transitive", "no-symmetry-breaking" })
+                    if (options_vars.count(o))
+                        key << " --" << o;
+                for (auto & o : { "initial-bound", "power", "add-dominated", "dominated-seed" })
+                    if (options_vars.count(o))
+                        key << " --" << o << "=" << options_vars[o].as<int>();
+                for (auto & o : { "dominated-edges", "join-dominated" })
+                    if (options_vars.count(o))
+                        key << " --" << o << "=" << options_vars[o].as<double>();
+                params.checkpoint_key = key.str();
+
+                if (options_vars.count("checkpoint"))
+                    params.checkpoint_file = options_vars["checkpoint"].as<std::string>();
+
+                if (options_vars.count("checkpoint-interval"))
+                    params.checkpoint_interval = std::chrono::seconds(options_vars["checkpoint-interval"].as<int>());
+
+                if (options_vars.count("resume")) {
+                    auto resume_file = options_vars["resume"].as<std::string>();
+                    resume = read_max_clique_checkpoint(resume_file);
+                    if (resume.key != params.checkpoint_key)
+                        throw CheckpointFileError{ resume_file, "it is for '" + resume.key + "', not '" + params.checkpoint_key + "'" };
+
+                    for (auto & set : { &resume.members, &resume.done })
+                        for (auto & v : *set)
+                            if (v < 0 || unsigned(v) >= graph.size() + dominated_vertices)
+                                throw CheckpointFileError{ resume_file, "vertex " + std::to_string(v) + " is not in the graph" };
+
+                    params.resume = &resume;
+                }
+            }
+
+            if (options_vars.count("print-cliques"))
+                params.enumerate_callback = [&] (const std::vector<int> & clique) {
+                    std::stringstream line;
+                    for (auto & v : clique)
+                        line << " " << graph.vertex_name(v);
+                    std::cout << lock_output() << "clique" << line.str() << std::endl;
+                };
+
             /* Do the actual run. */
             bool aborted = false;
-            auto result = run_with_modifications(std::get<1>(*algorithm),
+            auto result = run_with_modifications(run_algorithm,
+                    options_vars.count("local-search") ? options_vars["local-search"].as<int>() : 0,
+                    options_vars.count("reduce") || options_vars.count("reduce-colour"),
+                    options_vars.count("reduce-colour"),
                     dominated_vertices, dominated_edge_p, dominated_join_p, dominated_seed)(
                         graph,
                         params,
@@ -291,10 +540,30 @@ auto main(int argc, char * argv[]) -> int
             }
             std::cout << std::endl;
 
+            /* Upper bound, if we stopped early and know one */
+            if (result.upper_bound > result.size)
+                std::cout << "upper bound " << result.upper_bound << std::endl;
+
+            /* How far we think we got, if we stopped early */
+            if (0.0 != result.estimated_fraction_done || 0 != result.estimated_time_left.count()) {
+                std::stringstream line;
+                line << std::fixed << std::setprecision(2) << result.estimated_fraction_done * 100.0 << "% eta ";
+                if (milliseconds::max() == result.estimated_time_left)
+                    line << "unknown";
+                else
+                    line << result.estimated_time_left.count() / 1000 << "s";
+                std::cout << "progress " << line.str() << std::endl;
+            }
+
             /* Donation */
             if (params.work_donation)
                 std::cout << result.donations << std::endl;
 
+            /* Inference */
+            if (0 != result.inference_attempts)
+                std::cout << "inference " << result.inference_attempts << " " << result.inference_prunes << " "
+                    << duration_cast<milliseconds>(result.inference_time).count() << std::endl;
+
             if (options_vars.count("verify")) {
                 if (params.power > 1) {
                     if (! is_clique(power(graph, params.power), result.members)) {
@@ -302,6 +571,14 @@ auto main(int argc, char * argv[]) -> int
                         return EXIT_FAILURE;
                     }
                 }
+                else if (options_vars.count("independent-set")) {
+                    for (auto & v : result.members)
+                        for (auto & w : result.members)
+                            if (graph.adjacent(v, w)) {
+                                std::cerr << "Oops! not an independent set" << std::endl;
+                                return EXIT_FAILURE;
+                            }
+                }
                 else {
                     if (! is_clique(graph, result.members)) {
                         std::cerr << "Oops! not a clique" << std::endl;
@@ -0,0 +1,8 @@
+TARGET := solve_max_clique_mpi
+
+SOURCES := solve_max_clique_mpi.cc
+
+TGT_CXXFLAGS := $(mpi_cxxflags)
+TGT_LDFLAGS := -L${TARGET_DIR}
+TGT_LDLIBS := -lsolver -lmax_clique_mpi -lmax_clique -lthreads -lgraph $(boost_ldlibs) $(boost_mpi_ldlibs)
+TGT_PREREQS := libmax_clique_mpi.a libmax_clique.a libgraph.a libthreads.a libsolver.a
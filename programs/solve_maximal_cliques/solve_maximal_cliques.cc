@@ -0,0 +1,172 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#include <solver/solver.hh>
+
+#include <graph/graph.hh>
+#include <graph/file_formats.hh>
+#include <graph/is_clique.hh>
+
+#include <max_clique/bk_maximal_cliques.hh>
+
+#include <threads/output_lock.hh>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+
+using namespace parasols;
+namespace po = boost::program_options;
+
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+using std::chrono::milliseconds;
+
+auto main(int argc, char * argv[]) -> int
+{
+    try {
+        po::options_description display_options{ "Program options" };
+        display_options.add_options()
+            ("help",                                 "Display help information")
+            ("threads",            po::value<int>(), "Number of threads to use")
+            ("print-cliques",                        "Print every maximal clique as it is found (otherwise, just count them)")
+            ("timeout",            po::value<int>(), "Abort after this many seconds")
+            ("verify",                               "Verify that we have found a valid result (for sanity checking changes)")
+            ("format",             po::value<std::string>(), "Specify the format of the input")
+            ;
+
+        po::options_description all_options{ "All options" };
+        all_options.add_options()
+            ("input-file", po::value<std::vector<std::string> >(),
+                           "Specify the input file (DIMACS format, unless --format is specified). May be specified multiple times.")
+            ;
+
+        all_options.add(display_options);
+
+        po::positional_options_description positional_options;
+        positional_options
+            .add("input-file", -1)
+            ;
+
+        po::variables_map options_vars;
+        po::store(po::command_line_parser(argc, argv)
+                .options(all_options)
+                .positional(positional_options)
+                .run(), options_vars);
+        po::notify(options_vars);
+
+        /* --help? Show a message, and exit. */
+        if (options_vars.count("help")) {
+            std::cout << "Usage: " << argv[0] << " [options] file[...]" << std::endl;
+            std::cout << std::endl;
+            std::cout << display_options << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        /* No input file specified? Show a message and exit. */
+        if (options_vars.count("input-file") < 1) {
+            std::cout << "Usage: " << argv[0] << " [options] file[...]" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        /* For each input file... */
+        auto input_files = options_vars["input-file"].as<std::vector<std::string> >();
+        bool first = true;
+        for (auto & input_file : input_files) {
+            if (first)
+                first = false;
+            else
+                std::cout << "--" << std::endl;
+
+            /* Figure out what our options should be. */
+            MaxCliqueParams params;
+
+            if (options_vars.count("threads"))
+                params.n_threads = options_vars["threads"].as<int>();
+            else
+                params.n_threads = std::thread::hardware_concurrency();
+
+            /* Turn a format name into a runnable function. */
+            auto format = graph_file_formats.begin(), format_end = graph_file_formats.end();
+            if (options_vars.count("format"))
+                for ( ; format != format_end ; ++format)
+                    if (format->first == options_vars["format"].as<std::string>())
+                        break;
+
+            /* Unknown format? Show a message and exit. */
+            if (format == format_end) {
+                std::cerr << "Unknown format " << options_vars["format"].as<std::string>() << ", choose from:";
+                for (auto a : graph_file_formats)
+                    std::cerr << " " << a.first;
+                std::cerr << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            /* Read in the graph */
+            auto graph = std::get<1>(*format)(input_file, GraphOptions::None);
+
+            if (options_vars.count("print-cliques"))
+                params.enumerate_callback = [&] (const std::vector<int> & clique) {
+                    std::stringstream line;
+                    for (auto & v : clique)
+                        line << " " << graph.vertex_name(v);
+                    std::cout << lock_output() << "clique" << line.str() << std::endl;
+                };
+
+            /* Do the actual run. */
+            bool aborted = false;
+            auto result = run_this(bk_maximal_cliques)(
+                        graph,
+                        params,
+                        aborted,
+                        options_vars.count("timeout") ? options_vars["timeout"].as<int>() : 0);
+
+            /* Stop the clock. */
+            auto overall_time = duration_cast<milliseconds>(steady_clock::now() - params.start_time);
+
+            /* Display the results: how many, and a biggest one. */
+            std::cout << result.size << " " << result.nodes << " " << result.result_count;
+
+            if (aborted)
+                std::cout << " aborted";
+
+            std::cout << std::endl;
+
+            /* Members */
+            for (auto v : result.members)
+                std::cout << graph.vertex_name(v) << " ";
+            std::cout << std::endl;
+
+            /* Times */
+            std::cout << overall_time.count();
+            if (! result.times.empty()) {
+                for (auto t : result.times)
+                    std::cout << " " << t.count();
+            }
+            std::cout << std::endl;
+
+            if (options_vars.count("verify")) {
+                if (! is_clique(graph, result.members)) {
+                    std::cerr << "Oops! not a clique" << std::endl;
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch (const po::error & e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Try " << argv[0] << " --help" << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (const std::exception & e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
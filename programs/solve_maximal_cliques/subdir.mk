@@ -0,0 +1,7 @@
+TARGET := solve_maximal_cliques
+
+SOURCES := solve_maximal_cliques.cc
+
+TGT_LDFLAGS := -L${TARGET_DIR}
+TGT_LDLIBS := -lsolver -lmax_clique -lthreads -lgraph $(boost_ldlibs)
+TGT_PREREQS := libmax_clique.a libgraph.a libthreads.a libsolver.a
@@ -4,6 +4,7 @@
 #include <subgraph_isomorphism/supplemental_graphs.hh>
 
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
 #include <graph/template_voodoo.hh>
 #include <graph/degree_sort.hh>
 
@@ -37,7 +38,7 @@ namespace
         {
             unsigned v;
             unsigned popcount;
-            FixedBitSet<n_words_> values;
+            BitSet<n_words_> values;
         };
 
         using Domains = std::vector<Domain>;
@@ -45,6 +46,12 @@ namespace
 
         struct DummyFailedVariables
         {
+            DummyFailedVariables() = default;
+
+            explicit DummyFailedVariables(unsigned)
+            {
+            }
+
             auto independent_of(const Domains &, const Domains &) -> bool
             {
                 return false;
@@ -61,7 +68,14 @@ namespace
 
         struct RealFailedVariables
         {
-            FixedBitSet<n_words_> variables;
+            BitSet<n_words_> variables;
+
+            RealFailedVariables() = default;
+
+            explicit RealFailedVariables(unsigned size)
+            {
+                variables.resize(size);
+            }
 
             auto independent_of(const Domains & old_domains, const Domains & new_domains) -> bool
             {
@@ -98,14 +112,16 @@ namespace
         const bool use_full_all_different, use_cheap_all_different, dom_plus_deg;
 
         static constexpr int max_graphs = 1 + ((l_ - 1) * k_) + (induced_ ? 1 + (compose_induced_ ? (l_ >= 2 ? 2 : l_) * k_ : 0) : 0);
-        std::array<FixedBitGraph<n_words_>, max_graphs> target_graphs;
-        std::array<FixedBitGraph<n_words_>, max_graphs> pattern_graphs;
+        std::array<BitGraph<n_words_>, max_graphs> target_graphs;
+        std::array<BitGraph<n_words_>, max_graphs> pattern_graphs;
 
         std::vector<int> pattern_order, target_order, isolated_vertices;
-        std::array<int, n_words_ * bits_per_word> pattern_degree_tiebreak;
+        VertexArray<n_words_, int> pattern_degree_tiebreak;
 
         unsigned pattern_size, full_pattern_size, target_size;
 
+        std::chrono::milliseconds encode_time;
+
         SGI(const Graph & target, const Graph & pattern, const SubgraphIsomorphismParams & a, bool fa, bool ca, bool dpd) :
             params(a),
             use_full_all_different(fa),
@@ -126,23 +142,16 @@ namespace
                     pattern_order.push_back(v);
 
             // recode pattern to a bit graph
-            pattern_graphs.at(0).resize(pattern_size);
-            for (unsigned i = 0 ; i < pattern_size ; ++i)
-                for (unsigned j = 0 ; j < pattern_size ; ++j)
-                    if (pattern.adjacent(pattern_order.at(i), pattern_order.at(j)))
-                        pattern_graphs.at(0).add_edge(i, j);
+            encode_time = encode_bit_graph(pattern, pattern_order, params.n_threads, pattern_graphs.at(0));
 
             // determine ordering for target graph vertices
             std::iota(target_order.begin(), target_order.end(), 0);
             degree_sort(target, target_order, false);
 
             // recode target to a bit graph
-            target_graphs.at(0).resize(target_size);
-            for (unsigned i = 0 ; i < target_size ; ++i)
-                for (unsigned j = 0 ; j < target_size ; ++j)
-                    if (target.adjacent(target_order.at(i), target_order.at(j)))
-                        target_graphs.at(0).add_edge(i, j);
+            encode_time += encode_bit_graph(target, target_order, params.n_threads, target_graphs.at(0));
 
+            resize_vertex_array(pattern_degree_tiebreak, pattern_size);
             for (unsigned j = 0 ; j < pattern_size ; ++j)
                 pattern_degree_tiebreak.at(j) = pattern_graphs.at(0).degree(j);
         }
@@ -153,18 +162,21 @@ namespace
             for (auto & d : new_domains) {
                 // all different
                 d.values.unset(f_v);
+                bool counted = false;
 
                 // for each graph pair...
                 for (int g = 0 ; g < g_end ; ++g) {
                     // if we're adjacent...
                     if (pattern_graphs.at(g).adjacent(branch_v, d.v)) {
                         // ...then we can only be mapped to adjacent vertices
-                        target_graphs.at(g).intersect_with_row(f_v, d.values);
+                        d.popcount = target_graphs.at(g).intersect_with_row_and_popcount(f_v, d.values);
+                        counted = true;
                     }
                 }
 
                 // we might have removed values
-                d.popcount = d.values.popcount();
+                if (! counted)
+                    d.popcount = d.values.popcount();
                 if (0 == d.popcount) {
                     failed_variables.add(d.v);
                     return false;
@@ -172,7 +184,7 @@ namespace
             }
 
             if (use_cheap_all_different) {
-                FailedVariables all_different_failed_variables;
+                FailedVariables all_different_failed_variables{ pattern_size };
                 if (! cheap_all_different(new_domains, all_different_failed_variables)) {
                     failed_variables.add(all_different_failed_variables);
                     return false;
@@ -195,7 +207,7 @@ namespace
                 int g_end) -> std::pair<Search, FailedVariables>
         {
             if (params.abort->load())
-                return std::make_pair(Search::Aborted, FailedVariables());
+                return std::make_pair(Search::Aborted, FailedVariables{ pattern_size });
 
             ++nodes;
 
@@ -214,12 +226,12 @@ namespace
             }
 
             if (! branch_domain)
-                return std::make_pair(Search::Satisfiable, FailedVariables());
+                return std::make_pair(Search::Satisfiable, FailedVariables{ pattern_size });
 
             auto remaining = branch_domain->values;
             auto branch_v = branch_domain->v;
 
-            FailedVariables shared_failed_variables;
+            FailedVariables shared_failed_variables{ pattern_size };
             shared_failed_variables.add(branch_domain->v);
 
             for (int f_v = remaining.first_set_bit() ; f_v != -1 ; f_v = remaining.first_set_bit()) {
@@ -241,8 +253,8 @@ namespace
 
                 auto search_result = search(assignments, new_domains, nodes, g_end);
                 switch (search_result.first) {
-                    case Search::Satisfiable:    return std::make_pair(Search::Satisfiable, FailedVariables());
-                    case Search::Aborted:        return std::make_pair(Search::Aborted, FailedVariables());
+                    case Search::Satisfiable:    return std::make_pair(Search::Satisfiable, FailedVariables{ pattern_size });
+                    case Search::Aborted:        return std::make_pair(Search::Aborted, FailedVariables{ pattern_size });
                     case Search::Unsatisfiable:  break;
                 }
 
@@ -258,7 +270,8 @@ namespace
         auto initialise_domains(Domains & domains) -> bool
         {
             unsigned remaining_target_vertices = target_size;
-            FixedBitSet<n_words_> allowed_target_vertices;
+            BitSet<n_words_> allowed_target_vertices;
+            allowed_target_vertices.resize(target_size);
             allowed_target_vertices.set_up_to(target_size);
 
             while (true) {
@@ -276,9 +289,8 @@ namespace
                         patterns_degrees.at(g).at(i) = pattern_graphs.at(g).degree(i);
 
                     for (unsigned i = 0 ; i < target_size ; ++i) {
-                        FixedBitSet<n_words_> remaining = allowed_target_vertices;
-                        target_graphs.at(g).intersect_with_row(i, remaining);
-                        targets_degrees.at(g).at(i) = remaining.popcount();
+                        BitSet<n_words_> remaining = allowed_target_vertices;
+                        targets_degrees.at(g).at(i) = target_graphs.at(g).intersect_with_row_and_popcount(i, remaining);
                     }
                 }
 
@@ -313,6 +325,7 @@ namespace
 
                 for (unsigned i = 0 ; i < pattern_size ; ++i) {
                     domains.at(i).v = i;
+                    domains.at(i).values.resize(target_size);
                     domains.at(i).values.unset_all();
 
                     for (unsigned j = 0 ; j < target_size ; ++j) {
@@ -346,7 +359,9 @@ namespace
                     domains.at(i).popcount = domains.at(i).values.popcount();
                 }
 
-                FixedBitSet<n_words_> domains_union;
+                BitSet<n_words_> domains_union;
+
+                domains_union.resize(target_size);
                 for (auto & d : domains)
                     domains_union.union_with(d.values);
 
@@ -367,7 +382,8 @@ namespace
         auto cheap_all_different(Domains & domains, FailedVariables & failed_variables) -> bool
         {
             // pick domains smallest first, with tiebreaking
-            std::array<int, n_words_ * bits_per_word> domains_order;
+            VertexArray<n_words_, int> domains_order;
+            resize_vertex_array(domains_order, domains.size());
             std::iota(domains_order.begin(), domains_order.begin() + domains.size(), 0);
 
             std::sort(domains_order.begin(), domains_order.begin() + domains.size(),
@@ -377,7 +393,9 @@ namespace
                     });
 
             // counting all-different
-            FixedBitSet<n_words_> domains_so_far, hall;
+            BitSet<n_words_> domains_so_far, hall;
+            domains_so_far.resize(target_size);
+            hall.resize(target_size);
             unsigned neighbours_so_far = 0;
 
             for (int i = 0, i_end = domains.size() ; i != i_end ; ++i) {
@@ -520,6 +538,7 @@ namespace
         auto run() -> SubgraphIsomorphismResult
         {
             SubgraphIsomorphismResult result;
+            result.times.push_back(encode_time);
 
             if (full_pattern_size > target_size) {
                 /* some of our fixed size data structures will throw a hissy
@@ -534,7 +553,7 @@ namespace
             if (! initialise_domains(domains))
                 return result;
 
-            FailedVariables dummy_failed_variables;
+            FailedVariables dummy_failed_variables{ pattern_size };
             if (! cheap_all_different(domains, dummy_failed_variables))
                 return result;
 
@@ -573,10 +592,10 @@ auto parasols::gb_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, c
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, false, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
     else
         return select_graph_size<Apply<SGI, false, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
 }
 
 auto parasols::gbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -585,10 +604,10 @@ auto parasols::gbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs,
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
     else
         return select_graph_size<Apply<SGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
 }
 
 auto parasols::gbbj_nocompose_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -597,10 +616,10 @@ auto parasols::gbbj_nocompose_subgraph_isomorphism(const std::pair<Graph, Graph>
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, false, 3, 3, true, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
     else
         return select_graph_size<Apply<SGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
 }
 
 auto parasols::gbbj_nosup_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -609,10 +628,10 @@ auto parasols::gbbj_nosup_subgraph_isomorphism(const std::pair<Graph, Graph> & g
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, false, 1, 1, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
     else
         return select_graph_size<Apply<SGI, true, false, 1, 1, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
 }
 
 auto parasols::gbbj_nocad_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -621,10 +640,10 @@ auto parasols::gbbj_nocad_subgraph_isomorphism(const std::pair<Graph, Graph> & g
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, false, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, false, true);
     else
         return select_graph_size<Apply<SGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, false, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, false, true);
 }
 
 auto parasols::gbbj_fad_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -633,10 +652,10 @@ auto parasols::gbbj_fad_subgraph_isomorphism(const std::pair<Graph, Graph> & gra
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, true, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, true, true, true);
     else
         return select_graph_size<Apply<SGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, true, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, true, true, true);
 }
 
 auto parasols::dgbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -645,9 +664,9 @@ auto parasols::dgbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<SGI, true, true, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
     else
         return select_graph_size<Apply<SGI, true, true, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params, false, true, true);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params, false, true, true);
 }
 
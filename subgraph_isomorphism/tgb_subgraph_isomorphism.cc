@@ -4,6 +4,7 @@
 #include <subgraph_isomorphism/supplemental_graphs.hh>
 
 #include <graph/bit_graph.hh>
+#include <graph/encode_bit_graph.hh>
 #include <graph/template_voodoo.hh>
 #include <graph/degree_sort.hh>
 
@@ -254,14 +255,20 @@ namespace
         {
             unsigned v;
             unsigned popcount;
-            FixedBitSet<n_words_> values;
+            BitSet<n_words_> values;
         };
 
         using Domains = std::vector<Domain>;
-        using Assignments = std::array<unsigned, n_words_ * bits_per_word>;
+        using Assignments = VertexArray<n_words_, unsigned>;
 
         struct DummyFailedVariables
         {
+            DummyFailedVariables() = default;
+
+            explicit DummyFailedVariables(unsigned)
+            {
+            }
+
             auto independent_of(const Domains &, const Domains &) -> bool
             {
                 return false;
@@ -278,7 +285,14 @@ namespace
 
         struct RealFailedVariables
         {
-            FixedBitSet<n_words_> variables;
+            BitSet<n_words_> variables;
+
+            RealFailedVariables() = default;
+
+            explicit RealFailedVariables(unsigned size)
+            {
+                variables.resize(size);
+            }
 
             auto independent_of(const Domains & old_domains, const Domains & new_domains) -> bool
             {
@@ -321,14 +335,16 @@ namespace
         const SubgraphIsomorphismParams & params;
 
         static constexpr int max_graphs = 1 + ((l_ - 1) * k_) + (induced_ ? 1 + (compose_induced_ ? (l_ >= 2 ? 2 : l_) * k_ : 0) : 0);
-        std::array<FixedBitGraph<n_words_>, max_graphs> target_graphs;
-        std::array<FixedBitGraph<n_words_>, max_graphs> pattern_graphs;
+        std::array<BitGraph<n_words_>, max_graphs> target_graphs;
+        std::array<BitGraph<n_words_>, max_graphs> pattern_graphs;
 
         std::vector<int> pattern_order, target_order, isolated_vertices;
-        std::array<int, n_words_ * bits_per_word> pattern_degree_tiebreak;
+        VertexArray<n_words_, int> pattern_degree_tiebreak;
 
         unsigned pattern_size, full_pattern_size, target_size;
 
+        std::chrono::milliseconds encode_time;
+
         SubgraphIsomorphismResult result;
 
         std::atomic<bool> someone_found_a_solution{ false };
@@ -355,23 +371,16 @@ namespace
                     pattern_order.push_back(v);
 
             // recode pattern to a bit graph
-            pattern_graphs.at(0).resize(pattern_size);
-            for (unsigned i = 0 ; i < pattern_size ; ++i)
-                for (unsigned j = 0 ; j < pattern_size ; ++j)
-                    if (pattern.adjacent(pattern_order.at(i), pattern_order.at(j)))
-                        pattern_graphs.at(0).add_edge(i, j);
+            encode_time = encode_bit_graph(pattern, pattern_order, params.n_threads, pattern_graphs.at(0));
 
             // determine ordering for target graph vertices
             std::iota(target_order.begin(), target_order.end(), 0);
             degree_sort(target, target_order, false);
 
             // recode target to a bit graph
-            target_graphs.at(0).resize(target_size);
-            for (unsigned i = 0 ; i < target_size ; ++i)
-                for (unsigned j = 0 ; j < target_size ; ++j)
-                    if (target.adjacent(target_order.at(i), target_order.at(j)))
-                        target_graphs.at(0).add_edge(i, j);
+            encode_time += encode_bit_graph(target, target_order, params.n_threads, target_graphs.at(0));
 
+            resize_vertex_array(pattern_degree_tiebreak, pattern_size);
             for (unsigned j = 0 ; j < pattern_size ; ++j)
                 pattern_degree_tiebreak.at(j) = pattern_graphs.at(0).degree(j);
         }
@@ -382,25 +391,28 @@ namespace
             for (auto & d : new_domains) {
                 // all different
                 d.values.unset(f_v);
+                bool counted = false;
 
                 // for each graph pair...
                 for (int g = 0 ; g < g_end ; ++g) {
                     // if we're adjacent...
                     if (pattern_graphs.at(g).adjacent(branch_v, d.v)) {
                         // ...then we can only be mapped to adjacent vertices
-                        target_graphs.at(g).intersect_with_row(f_v, d.values);
+                        d.popcount = target_graphs.at(g).intersect_with_row_and_popcount(f_v, d.values);
+                        counted = true;
                     }
                 }
 
                 // we might have removed values
-                d.popcount = d.values.popcount();
+                if (! counted)
+                    d.popcount = d.values.popcount();
                 if (0 == d.popcount) {
                     failed_variables.add(d.v);
                     return false;
                 }
             }
 
-            FailedVariables all_different_failed_variables;
+            FailedVariables all_different_failed_variables{ pattern_size };
             if (! cheap_all_different(new_domains, all_different_failed_variables)) {
                 failed_variables.add(all_different_failed_variables);
                 return false;
@@ -441,7 +453,7 @@ namespace
                 ) -> std::pair<Search, FailedVariables>
         {
             if (params.abort->load() || someone_found_a_solution.load() || kill_function())
-                return std::make_pair(Search::Aborted, FailedVariables());
+                return std::make_pair(Search::Aborted, FailedVariables{ pattern_size });
 
             ++nodes;
 
@@ -455,16 +467,18 @@ namespace
 
             if (! branch_domain) {
                 someone_found_a_solution.store(true);
-                return std::make_pair(Search::Satisfiable, FailedVariables());
+                return std::make_pair(Search::Satisfiable, FailedVariables{ pattern_size });
             }
 
             auto remaining = branch_domain->values;
             auto branch_v = branch_domain->v;
 
-            FailedVariables shared_failed_variables;
+            FailedVariables shared_failed_variables{ pattern_size };
             shared_failed_variables.add(branch_domain->v);
 
-            std::array<int, n_words_ * bits_per_word> branch;
+            VertexArray<n_words_, int> branch;
+
+            resize_vertex_array(branch, target_size);
             int branch_end = 0;
             for (int f_v = remaining.first_set_bit() ; f_v != -1 ; f_v = remaining.first_set_bit()) {
                 remaining.unset(f_v);
@@ -479,7 +493,9 @@ namespace
                 FailedVariables,
                 Assignments>;
 
-            std::array<ThisThreadData, n_words_ * bits_per_word> all_threads_data;
+            VertexArray<n_words_, ThisThreadData> all_threads_data;
+
+            resize_vertex_array(all_threads_data, branch_end);
 
             auto this_thread_function = [&] () {
                 for (int b = shared_b++ ; b < branch_end ; b = shared_b++) {
@@ -488,7 +504,7 @@ namespace
                     FailedVariables & this_thread_failed_variables = std::get<2>(all_threads_data.at(b));
                     Assignments & this_thread_assignments = std::get<3>(all_threads_data.at(b));
 
-                    this_thread_failed_variables = FailedVariables();
+                    this_thread_failed_variables = FailedVariables{ pattern_size };
                     this_thread_assignments = assignments;
                     this_thread_keep_going = true;
 
@@ -596,7 +612,7 @@ namespace
                 ) -> std::pair<Search, FailedVariables>
         {
             if (params.abort->load() || someone_found_a_solution.load() || kill_function())
-                return std::make_pair(Search::Aborted, FailedVariables());
+                return std::make_pair(Search::Aborted, FailedVariables{ pattern_size });
 
             ++nodes;
 
@@ -610,16 +626,18 @@ namespace
 
             if (! branch_domain) {
                 someone_found_a_solution.store(true);
-                return std::make_pair(Search::Satisfiable, FailedVariables());
+                return std::make_pair(Search::Satisfiable, FailedVariables{ pattern_size });
             }
 
             auto remaining = branch_domain->values;
             auto branch_v = branch_domain->v;
 
-            FailedVariables shared_failed_variables;
+            FailedVariables shared_failed_variables{ pattern_size };
             shared_failed_variables.add(branch_domain->v);
 
-            std::array<int, n_words_ * bits_per_word> branch;
+            VertexArray<n_words_, int> branch;
+
+            resize_vertex_array(branch, target_size);
             int branch_end = 0;
             for (int f_v = remaining.first_set_bit() ; f_v != -1 ; f_v = remaining.first_set_bit()) {
                 remaining.unset(f_v);
@@ -628,7 +646,7 @@ namespace
 
             std::pair<Search, FailedVariables> this_thread_result;
             bool this_thread_keep_going = true;
-            FailedVariables this_thread_failed_variables;
+            FailedVariables this_thread_failed_variables{ pattern_size };
             Assignments this_thread_assignments = assignments;
 
             for (int b = 0 ; b < branch_end ; ++b) {
@@ -652,12 +670,12 @@ namespace
 
                 switch (search_result.first) {
                     case Search::Satisfiable:
-                        this_thread_result = std::make_pair(Search::Satisfiable, FailedVariables());
+                        this_thread_result = std::make_pair(Search::Satisfiable, FailedVariables{ pattern_size });
                         this_thread_keep_going = false;
                         break;
 
                     case Search::Aborted:
-                        this_thread_result = std::make_pair(Search::Aborted, FailedVariables());
+                        this_thread_result = std::make_pair(Search::Aborted, FailedVariables{ pattern_size });
                         this_thread_keep_going = false;
                         break;
 
@@ -687,7 +705,8 @@ namespace
         auto initialise_domains(Domains & domains) -> bool
         {
             unsigned remaining_target_vertices = target_size;
-            FixedBitSet<n_words_> allowed_target_vertices;
+            BitSet<n_words_> allowed_target_vertices;
+            allowed_target_vertices.resize(target_size);
             allowed_target_vertices.set_up_to(target_size);
 
             while (true) {
@@ -705,9 +724,8 @@ namespace
                         patterns_degrees.at(g).at(i) = pattern_graphs.at(g).degree(i);
 
                     for (unsigned i = 0 ; i < target_size ; ++i) {
-                        FixedBitSet<n_words_> remaining = allowed_target_vertices;
-                        target_graphs.at(g).intersect_with_row(i, remaining);
-                        targets_degrees.at(g).at(i) = remaining.popcount();
+                        BitSet<n_words_> remaining = allowed_target_vertices;
+                        targets_degrees.at(g).at(i) = target_graphs.at(g).intersect_with_row_and_popcount(i, remaining);
                     }
                 }
 
@@ -758,6 +776,7 @@ namespace
                     tasks.add([&] {
                         for (unsigned i ; ((i = posi++)) < pattern_size ; ) {
                             domains.at(i).v = i;
+                            domains.at(i).values.resize(target_size);
                             domains.at(i).values.unset_all();
 
                             for (unsigned j = 0 ; j < target_size ; ++j) {
@@ -795,7 +814,9 @@ namespace
 
                 tasks.complete();
 
-                FixedBitSet<n_words_> domains_union;
+                BitSet<n_words_> domains_union;
+
+                domains_union.resize(target_size);
                 for (auto & d : domains)
                     domains_union.union_with(d.values);
 
@@ -816,7 +837,8 @@ namespace
         auto cheap_all_different(Domains & domains, FailedVariables & failed_variables) -> bool
         {
             // pick domains smallest first, with tiebreaking
-            std::array<int, n_words_ * bits_per_word> domains_order;
+            VertexArray<n_words_, int> domains_order;
+            resize_vertex_array(domains_order, domains.size());
             std::iota(domains_order.begin(), domains_order.begin() + domains.size(), 0);
 
             std::sort(domains_order.begin(), domains_order.begin() + domains.size(),
@@ -826,7 +848,9 @@ namespace
                     });
 
             // counting all-different
-            FixedBitSet<n_words_> domains_so_far, hall;
+            BitSet<n_words_> domains_so_far, hall;
+            domains_so_far.resize(target_size);
+            hall.resize(target_size);
             unsigned neighbours_so_far = 0;
 
             for (int i = 0, i_end = domains.size() ; i != i_end ; ++i) {
@@ -879,6 +903,8 @@ namespace
 
         auto run() -> SubgraphIsomorphismResult
         {
+            result.times.push_back(encode_time);
+
             if (full_pattern_size > target_size) {
                 /* some of our fixed size data structures will throw a hissy
                  * fit. check this early. */
@@ -892,13 +918,14 @@ namespace
             if (! initialise_domains(domains))
                 return result;
 
-            FailedVariables dummy_failed_variables;
+            FailedVariables dummy_failed_variables{ pattern_size };
             if (! cheap_all_different(domains, dummy_failed_variables))
                 return result;
 
             prepare_for_search(domains);
 
             Assignments assignments;
+            resize_vertex_array(assignments, pattern_size);
             std::atomic<unsigned long long> nodes{ 0 };
             Position position;
             switch (search(assignments, domains, nodes, max_graphs, 0, position, [] () -> bool { return false; }).first) {
@@ -940,10 +967,10 @@ auto parasols::ttgbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graph
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<TSGI, true, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
     else
         return select_graph_size<Apply<TSGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
 }
 
 auto parasols::ttdgbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -952,10 +979,10 @@ auto parasols::ttdgbbj_subgraph_isomorphism(const std::pair<Graph, Graph> & grap
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<TSGI, true, false, 3, 3, true, true>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
     else
         return select_graph_size<Apply<TSGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
 }
 
 auto parasols::ttgbbjnocompose_subgraph_isomorphism(const std::pair<Graph, Graph> & graphs, const SubgraphIsomorphismParams & params) -> SubgraphIsomorphismResult
@@ -964,9 +991,9 @@ auto parasols::ttgbbjnocompose_subgraph_isomorphism(const std::pair<Graph, Graph
         return SubgraphIsomorphismResult{ };
     if (params.induced)
         return select_graph_size<Apply<TSGI, true, false, 3, 3, true, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
     else
         return select_graph_size<Apply<TSGI, true, false, 3, 3, false, false>::template Type, SubgraphIsomorphismResult>(
-                AllGraphSizes(), graphs.second, graphs.first, params);
+                AllGraphSizesAndDynamic(), graphs.second, graphs.first, params);
 }
 
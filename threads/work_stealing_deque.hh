@@ -0,0 +1,174 @@
+/* vim: set sw=4 sts=4 et foldmethod=syntax : */
+
+#ifndef PARASOLS_GUARD_THREADS_WORK_STEALING_DEQUE_HH
+#define PARASOLS_GUARD_THREADS_WORK_STEALING_DEQUE_HH 1
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <limits>
+
+namespace parasols
+{
+    /**
+     * A Chase-Lev style deque for splitting up a depth-first search, one per
+     * thread.
+     *
+     * The entries are the levels of the owner's current search path, which
+     * the owner opens and closes at the bottom as it goes deeper and comes
+     * back up. Each open level is a loop over children, and a child is
+     * identified by its position in that loop. Thieves work from the top,
+     * taking one not yet started child from the shallowest level that has
+     * any, and get back a subproblem as the position of the owner's child at
+     * every level above, followed by the position they took. The owner
+     * claims each child in turn before branching on it, and skips anything
+     * that was stolen.
+     *
+     * Claims on a level are a compare and swap on one word holding an epoch
+     * and the next unclaimed position, so nothing is ever locked. The epoch
+     * changes each time a level is opened, so a thief can't take a child
+     * from a level that was closed and reopened under it.
+     */
+    class WorkStealingDeque
+    {
+        private:
+            static const constexpr unsigned long long closed = std::numeric_limits<unsigned>::max();
+
+            struct Level
+            {
+                /// Epoch in the high half, next unclaimed position in the low.
+                std::atomic<unsigned long long> claim;
+
+                /// How many children this level has.
+                std::atomic<int> end;
+
+                /// Which child the owner is currently under.
+                std::atomic<int> offset;
+
+                Level()
+                {
+                    claim.store(closed, std::memory_order_relaxed);
+                    end.store(0, std::memory_order_relaxed);
+                    offset.store(0, std::memory_order_relaxed);
+                }
+            };
+
+            std::unique_ptr<Level[]> _levels;
+            std::atomic<int> _bottom;
+
+        public:
+            /**
+             * We can go at most max_depth levels deep.
+             */
+            explicit WorkStealingDeque(int max_depth) :
+                _levels(new Level[max_depth + 1])
+            {
+                _bottom.store(0, std::memory_order_relaxed);
+            }
+
+            WorkStealingDeque(const WorkStealingDeque &) = delete;
+            WorkStealingDeque & operator= (const WorkStealingDeque &) = delete;
+
+            /**
+             * Owner only: we're about to loop over the children of a node at
+             * this depth. Everything above must already be open or be forced
+             * by our own subproblem, with set_offset() called for it.
+             */
+            auto open(int depth, int number_of_children) -> void
+            {
+                Level & level = _levels[depth];
+                unsigned long long epoch = (level.claim.load(std::memory_order_relaxed) >> 32) + 1;
+                level.end.store(number_of_children, std::memory_order_relaxed);
+                level.claim.store(epoch << 32, std::memory_order_release);
+                _bottom.store(depth + 1, std::memory_order_release);
+            }
+
+            /**
+             * Owner only: we're done with this depth. Anything which wasn't
+             * claimed is gone.
+             */
+            auto close(int depth) -> void
+            {
+                Level & level = _levels[depth];
+                unsigned long long epoch = level.claim.load(std::memory_order_relaxed) >> 32;
+                level.claim.store((epoch << 32) | closed, std::memory_order_release);
+                _bottom.store(depth, std::memory_order_release);
+            }
+
+            /**
+             * Owner only: we're under this child at a depth which we didn't
+             * open, because it's forced by our own subproblem.
+             */
+            auto set_offset(int depth, int position) -> void
+            {
+                _levels[depth].offset.store(position, std::memory_order_release);
+            }
+
+            /**
+             * Owner only: we'd like to branch on the child in this position
+             * at an open depth. Returns false if a thief got there first.
+             */
+            auto claim(int depth, int position) -> bool
+            {
+                Level & level = _levels[depth];
+                unsigned long long c = level.claim.load(std::memory_order_acquire);
+                while (true) {
+                    if ((c & closed) > unsigned(position))
+                        return false;
+
+                    if (level.claim.compare_exchange_weak(c, (c & ~closed) | (position + 1),
+                                std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        set_offset(depth, position);
+                        return true;
+                    }
+                }
+            }
+
+            /**
+             * Thieves only: try to take the shallowest child that nobody has
+             * started yet. On success, offsets holds the position to take at
+             * each depth to get to it.
+             */
+            auto steal(std::vector<int> & offsets) -> bool
+            {
+                int bottom = _bottom.load(std::memory_order_acquire);
+                for (int depth = 0 ; depth < bottom ; ++depth) {
+                    Level & level = _levels[depth];
+                    unsigned long long c = level.claim.load(std::memory_order_acquire);
+                    while ((c & closed) != closed && int(c & closed) < level.end.load(std::memory_order_relaxed)) {
+                        offsets.resize(depth + 1);
+                        for (int d = 0 ; d < depth ; ++d)
+                            offsets[d] = _levels[d].offset.load(std::memory_order_relaxed);
+                        offsets[depth] = c & closed;
+
+                        /* If the owner has moved on since we read the claim,
+                         * what we just read might be from somewhere else, but
+                         * then the claim will have changed too. */
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (level.claim.compare_exchange_weak(c, c + 1,
+                                    std::memory_order_acq_rel, std::memory_order_acquire))
+                            return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /**
+             * Thieves only: is there anything which steal() might take? This
+             * is a hint, and might be out of date by the time it returns.
+             */
+            auto might_have_work() const -> bool
+            {
+                int bottom = _bottom.load(std::memory_order_acquire);
+                for (int depth = 0 ; depth < bottom ; ++depth) {
+                    unsigned long long c = _levels[depth].claim.load(std::memory_order_acquire);
+                    if ((c & closed) != closed && int(c & closed) < _levels[depth].end.load(std::memory_order_relaxed))
+                        return true;
+                }
+                return false;
+            }
+    };
+}
+
+#endif